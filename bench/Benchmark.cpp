@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+namespace Benchmark {
+Result Run(const std::string &name, size_t scale, size_t items,
+           const Options &options, const std::function<void()> &function) {
+  for (size_t i{0}; i < options.warmup; i++) {
+    function();
+  }
+
+  std::vector<uint64_t> times(std::max<size_t>(options.repetitions, 1));
+  for (uint64_t &time : times) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    time = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count());
+  }
+  std::sort(times.begin(), times.end());
+
+  uint64_t total{0};
+  for (uint64_t time : times) {
+    total += time;
+  }
+  return {name,
+          scale,
+          items,
+          times.size(),
+          times.front(),
+          total / times.size(),
+          Percentile(times, 50),
+          Percentile(times, 90),
+          Percentile(times, 99),
+          times.back()};
+}
+
+uint64_t Percentile(const std::vector<uint64_t> &sorted, double percentile) {
+  double rank = percentile / 100 * static_cast<double>(sorted.size() - 1);
+  size_t below = static_cast<size_t>(std::floor(rank));
+  size_t above = std::min(below + 1, sorted.size() - 1);
+  double fraction = rank - static_cast<double>(below);
+  return static_cast<uint64_t>(
+      static_cast<double>(sorted[below]) +
+      fraction * (static_cast<double>(sorted[above]) -
+                  static_cast<double>(sorted[below])));
+}
+
+void PrintHeadings(std::ostream &os) {
+  os << std::left << std::setw(28) << "benchmark" << std::right
+     << std::setw(8) << "scale" << std::setw(10) << "items" << std::setw(14)
+     << "p50 (us)" << std::setw(14) << "p90 (us)" << std::setw(14)
+     << "p99 (us)" << std::setw(14) << "max (us)" << std::endl;
+}
+
+void Print(std::ostream &os, const Result &result) {
+  auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000; };
+  os << std::left << std::setw(28) << result.name << std::right
+     << std::setw(7) << result.scale << "x" << std::setw(10) << result.items
+     << std::fixed << std::setprecision(1) << std::setw(14) << us(result.p50)
+     << std::setw(14) << us(result.p90) << std::setw(14) << us(result.p99)
+     << std::setw(14) << us(result.max) << std::endl;
+}
+
+std::string ToJSON(const std::vector<Result> &results) {
+  std::string out{"{\n  \"benchmarks\": ["};
+  for (size_t i{0}; i < results.size(); i++) {
+    const Result &result = results[i];
+    // names are only letters, digits and / so they don't need escaping
+    out += std::string{i == 0 ? "" : ","} + "\n    {\"name\": \"" +
+           result.name + "\", \"scale\": " + std::to_string(result.scale) +
+           ", \"items\": " + std::to_string(result.items) +
+           ", \"repetitions\": " + std::to_string(result.repetitions) +
+           ", \"min_ns\": " + std::to_string(result.min) +
+           ", \"mean_ns\": " + std::to_string(result.mean) +
+           ", \"p50_ns\": " + std::to_string(result.p50) +
+           ", \"p90_ns\": " + std::to_string(result.p90) +
+           ", \"p99_ns\": " + std::to_string(result.p99) +
+           ", \"max_ns\": " + std::to_string(result.max) + "}";
+  }
+  return out + "\n  ]\n}\n";
+}
+} // namespace Benchmark
@@ -0,0 +1,88 @@
+/**
+ * @file Benchmark.h
+ * @brief Benchmark namespace times functions repeatedly, and reports the
+ * results as a table and as JSON.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark namespace times functions repeatedly, and reports the
+ * results as a table and as JSON.
+ */
+namespace Benchmark {
+
+/** @brief How to run the benchmarks */
+struct Options {
+  /** @brief The number of untimed runs before the timed ones */
+  size_t warmup;
+  /** @brief The number of timed runs */
+  size_t repetitions;
+  /** @brief Only benchmarks whose names contain this are run */
+  std::string filter;
+};
+
+/** @brief The timings of one benchmark, in nanoseconds */
+struct Result {
+  std::string name;
+  /** @brief The size of the data, as a multiple of the real data */
+  size_t scale;
+  /** @brief The number of things each run processes, e.g. heroes */
+  size_t items;
+  size_t repetitions;
+  uint64_t min;
+  uint64_t mean;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t max;
+};
+
+/**
+ * @brief Runs a function options.warmup times, then times it
+ * options.repetitions times.
+ * @param &name The name of the benchmark, e.g. Filter/Race
+ * @param scale The size of the data
+ * @param items The number of things each run processes
+ * @param &options How to run it
+ * @param &function The function
+ * @return the timings
+ */
+Result Run(const std::string &name, size_t scale, size_t items,
+           const Options &options, const std::function<void()> &function);
+
+/**
+ * @brief The value at a percentile of some sorted values, interpolating
+ * between the nearest two.
+ * @param &sorted The values, in ascending order, not empty
+ * @param percentile Between 0 and 100
+ */
+uint64_t Percentile(const std::vector<uint64_t> &sorted, double percentile);
+
+/** @brief Prints the headings of the table Print prints rows of */
+void PrintHeadings(std::ostream &os);
+
+/** @brief Prints a result as a row of a table */
+void Print(std::ostream &os, const Result &result);
+
+/**
+ * @param &results The results
+ * @return the results as a JSON document: {"benchmarks": [{"name": ...,
+ * "scale": ..., "items": ..., "repetitions": ..., "min_ns": ..., ...}, ...]}
+ */
+std::string ToJSON(const std::vector<Result> &results);
+
+/**
+ * @brief Keeps the compiler from optimising away a value that isn't used
+ * otherwise.
+ */
+template <typename T> void DoNotOptimise(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+} // namespace Benchmark
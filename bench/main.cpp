@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "AddOwned.h"
+#include "Benchmark.h"
+#include "Catalog.h"
+#include "Diff.h"
+#include "Filter.h"
+#include "Generator.h"
+#include "GroupBy.h"
+#include "Hero.h"
+#include "Heroes.h"
+#include "Memory.h"
+#include "Order.h"
+#include "Render.h"
+#include "Search.h"
+#include "Utilities.h"
+
+namespace {
+/** @brief The number of heroes in the real heroes.csv */
+constexpr uint64_t REAL_HEROES{309};
+
+/** @brief The default limits of the memory a catalog uses, per hero */
+constexpr double MAX_BYTES_PER_HERO{1500};
+constexpr double MAX_PROFILE_BYTES_PER_HERO{320};
+
+/** @brief The arguments of each condition that's benchmarked */
+const std::map<std::string, std::vector<std::string>> ARGUMENTS{
+    {"Attribute", {"Speed"}},
+    {"StartingGrade", {"SSR"}},
+    {"Character", {"Meliodas"}},
+    {"LR", {}},
+    {"Race", {"Demon"}},
+    {"Characteristic", {"Ragnarok"}},
+    {"Good", {"1", "2"}},
+    {"GoodAsOf", {"Amazing's PVP", "0", "1", "2"}},
+    {"Owned", {}},
+    {"Acquirable", {}},
+    {"AvailableByMethod", {"Draw 0"}},
+    {"Upgraded", {"80"}},
+    {"HeroContains", {"[legend 1", "mage"}},
+    {"MethodContains", {"draw 1"}}};
+
+/** @brief The most memory a catalog may use, so memory regressions fail */
+struct Limits {
+  /** @brief bytes per hero of the whole catalog */
+  double per_hero;
+  /** @brief bytes per hero of the profile, i.e. of one account */
+  double profile_per_hero;
+};
+
+/** @brief Makes a directory, if it doesn't exist */
+void MakeDirectory(const std::string &path) {
+#ifdef _WIN32
+  mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0755);
+#endif
+}
+
+/** @return the numbers in a comma-separated list, e.g. 1,100 */
+std::vector<size_t> ParseScales(const std::string &str) {
+  std::vector<size_t> out{};
+  for (const std::string &scale : Utilities::ParseCSV(str)) {
+    out.push_back(static_cast<size_t>(std::stoul(scale)));
+  }
+  return out;
+}
+
+/**
+ * @brief Prints the memory a catalog uses, and checks it's within the limits.
+ * @return whether it's within the limits
+ */
+bool CheckMemory(const Catalog &catalog, size_t scale, const Limits &limits) {
+  Memory::Footprint footprint = Memory::Measure(catalog);
+  double per_hero = footprint.BytesPerHero();
+  double profile_per_hero =
+      footprint.heroes == 0 ? 0.0
+                            : static_cast<double>(footprint.profile) /
+                                  static_cast<double>(footprint.heroes);
+  std::ios::fmtflags flags = std::cout.flags();
+  std::cout << std::fixed << std::setprecision(1);
+  std::cerr << std::fixed << std::setprecision(1);
+  std::cout << "Memory at x" << scale << ": " << footprint.Total()
+            << " bytes, " << per_hero << " per hero; " << footprint.profile
+            << " bytes per account, " << profile_per_hero << " per hero"
+            << std::endl;
+  bool ok{true};
+  if (per_hero > limits.per_hero) {
+    std::cerr << "Memory regression at x" << scale << ": " << per_hero
+              << " bytes per hero is more than the limit of "
+              << limits.per_hero << "." << std::endl;
+    ok = false;
+  }
+  if (profile_per_hero > limits.profile_per_hero) {
+    std::cerr << "Memory regression at x" << scale << ": "
+              << profile_per_hero
+              << " bytes per hero for each account is more than the limit of "
+              << limits.profile_per_hero << "." << std::endl;
+    ok = false;
+  }
+  std::cout.flags(flags);
+  return ok;
+}
+
+/**
+ * @brief Runs every benchmark on the data at one scale
+ * @return whether the memory used is within the limits
+ */
+bool RunAll(const std::string &data_dir, size_t scale,
+            const Benchmark::Options &options, const Limits &limits,
+            std::vector<Benchmark::Result> &results) {
+  auto run = [&](const std::string &name, size_t items,
+                 const std::function<void()> &function) {
+    if (name.find(options.filter) == std::string::npos) {
+      return;
+    }
+    results.push_back(Benchmark::Run(name, scale, items, options, function));
+    Benchmark::Print(std::cout, results.back());
+  };
+
+  // CSV records, released before the heroes are loaded
+  size_t count{0};
+  {
+    std::vector<std::string> lines =
+        Utilities::ReadLines(data_dir + "/heroes.csv");
+    std::vector<std::vector<std::string>> records{};
+    for (const std::string &line : lines) {
+      records.push_back(Utilities::ParseCSV(line));
+    }
+    run("Utilities/ParseCSV", lines.size(), [&lines]() {
+      for (const std::string &line : lines) {
+        Benchmark::DoNotOptimise(Utilities::ParseCSV(line).size());
+      }
+    });
+    run("Utilities/MakeCSV", records.size(), [&records]() {
+      for (const std::vector<std::string> &record : records) {
+        Benchmark::DoNotOptimise(Utilities::MakeCSV(record).size());
+      }
+    });
+    count = lines.size();
+  }
+  size_t draws = Utilities::ReadLists(data_dir + "/draws.txt").size();
+  run("Utilities/ReadLists", draws, [&data_dir]() {
+    Benchmark::DoNotOptimise(
+        Utilities::ReadLists(data_dir + "/draws.txt").size());
+  });
+
+  // loading everything
+  run("Heroes/MakeHeroes", count, [&data_dir]() {
+    Catalog catalog{data_dir};
+    Heroes::MakeHeroes(catalog);
+    Benchmark::DoNotOptimise(catalog.list.size());
+  });
+
+  // filtering, without the cache
+  Catalog catalog{data_dir};
+  Heroes::MakeHeroes(catalog);
+  bool ok = CheckMemory(catalog, scale, limits);
+  auto filter = [&](const std::string &name,
+                    const Filter::Expression &expression) {
+    run("Filter/" + name, catalog.list.size(), [&catalog, &expression]() {
+      Filter::Condition condition = Filter::Compile(catalog, expression);
+      Benchmark::DoNotOptimise(
+          Utilities::Select(catalog.list, condition).size());
+    });
+  };
+  for (const Filter::ConditionFunction &condition : Filter::conditions) {
+    auto arguments = ARGUMENTS.find(condition.name);
+    if (arguments == ARGUMENTS.end()) {
+      std::cerr << "No arguments for condition " << condition.name
+                << ", so it isn't benchmarked." << std::endl;
+      continue;
+    }
+    filter(condition.name, {condition.name, arguments->second, {}});
+  }
+  Filter::Expression race{"Race", ARGUMENTS.at("Race"), {}};
+  Filter::Expression good{"Good", ARGUMENTS.at("Good"), {}};
+  filter("And", {"And", {}, {race, good}});
+  filter("Or", {"Or", {}, {race, good}});
+  filter("Not", {"Not", {}, {race}});
+  run("Utilities/Select", catalog.list.size(), [&catalog]() {
+    Benchmark::DoNotOptimise(
+        Utilities::Select(catalog.list,
+                          std::function<bool(const Hero &)>{
+                              [](const Hero &hero) { return hero.owned; }})
+            .size());
+  });
+
+  // sorting every hero, and finding the best few
+  std::vector<size_t> rows(catalog.list.size());
+  for (size_t i{0}; i < rows.size(); i++) {
+    rows[i] = i;
+  }
+  const std::vector<Order::Key> order =
+      Order::Parse("BestTier, Grade DESC, Ultimate DESC");
+  run("Order/Sort", rows.size(), [&catalog, &rows, &order]() {
+    Benchmark::DoNotOptimise(Order::Sort(catalog, rows, order).size());
+  });
+  run("Order/Top10", rows.size(), [&catalog, &rows, &order]() {
+    Benchmark::DoNotOptimise(Order::Top(catalog, rows, order, 10).size());
+  });
+
+  // writing every hero in each format, to a stream that discards it, so only
+  // formatting is timed
+  std::ostream discard{nullptr};
+  const std::vector<std::pair<std::string, Render::Format>> formats{
+      {"Text", Render::Format::TEXT},
+      {"CSV", Render::Format::CSV},
+      {"JSONL", Render::Format::JSONL},
+      {"Table", Render::Format::TABLE}};
+  for (const auto &format : formats) {
+    run("Render/" + format.first, rows.size(),
+        [&catalog, &rows, &discard, &format]() {
+          Render::Renderer renderer{discard, catalog, format.second};
+          renderer.Add(rows);
+        });
+  }
+  run("Render/Print", rows.size(), [&catalog, &discard]() {
+    for (const Hero &hero : catalog.list) {
+      hero.Print(discard, catalog) << std::endl;
+    }
+  });
+
+  // summarizing every hero by two keys, and by a key with several values
+  const std::vector<GroupBy::Aggregate> aggregates = GroupBy::ParseAggregates(
+      catalog, "Count, PercentOwned, Avg(Ultimate), Min(BestTier)");
+  run("GroupBy/AttributeByGrade", rows.size(),
+      [&catalog, &rows, &aggregates]() {
+        Benchmark::DoNotOptimise(
+            GroupBy::Run(catalog, rows, {"Attribute", "StartingGrade"},
+                         aggregates)
+                .rows.size());
+      });
+  run("GroupBy/Race", rows.size(), [&catalog, &rows, &aggregates]() {
+    Benchmark::DoNotOptimise(
+        GroupBy::Run(catalog, rows, {"Race"}, aggregates).rows.size());
+  });
+
+  // searching for the start of characters, and for names with two letters
+  // swapped, from heroes spread over the catalog
+  std::vector<std::string> prefixes{};
+  std::vector<std::string> typos{};
+  const size_t step = std::max<size_t>(catalog.list.size() / 1000, 1);
+  for (size_t i{0}; i < catalog.list.size(); i += step) {
+    prefixes.push_back(catalog.list[i].character.str().substr(0, 4));
+    std::string name = catalog.list[i].name.str();
+    if (name.size() > 3) {
+      std::swap(name[1], name[2]);
+    }
+    typos.push_back(name);
+  }
+  run("Search/Build", catalog.list.size(), [&catalog]() {
+    Search::Index index{};
+    index.Build(catalog.list);
+    Benchmark::DoNotOptimise(index.Bytes());
+  });
+  run("Search/Complete", prefixes.size(), [&catalog, &prefixes]() {
+    for (const std::string &prefix : prefixes) {
+      Benchmark::DoNotOptimise(catalog.search.Complete(prefix, 10).size());
+    }
+  });
+  run("Search/Fuzzy", typos.size(), [&catalog, &typos]() {
+    for (const std::string &typo : typos) {
+      Benchmark::DoNotOptimise(catalog.search.Suggest(typo, 10).size());
+    }
+  });
+
+  // comparing the owned heroes with a copy of them with some changed, and
+  // some removed
+  const Diff::Snapshot before = Diff::Current(catalog);
+  Diff::Snapshot after{};
+  for (size_t i{0}; i < before.size(); i++) {
+    if (i % 20 != 0) {
+      after.push_back(before[i]);
+    }
+    if (i % 10 == 5) {
+      after.back().upgrades[Hero::LEVEL] = "1";
+    }
+  }
+  run("Diff/Compare", before.size(), [&before, &after]() {
+    Benchmark::DoNotOptimise(Diff::Compare(before, after).size());
+  });
+
+  // saving owned heroes
+  run("AddOwned/UpdateFile", catalog.list.size(),
+      [&catalog]() { AddOwned::UpdateFile(catalog); });
+  return ok;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // 10000x needs several GB of memory, so it only runs when asked for
+  std::vector<size_t> scales{1, 100};
+  Benchmark::Options options{2, 10, ""};
+  std::string directory{"bench-data"};
+  std::string json{"sdsgc-bench.json"};
+  uint64_t seed{1};
+  // about twice what's used now
+  Limits limits{MAX_BYTES_PER_HERO, MAX_PROFILE_BYTES_PER_HERO};
+
+  for (int i{1}; i < argc; i++) {
+    std::string arg{argv[i]};
+    if (i + 1 >= argc) {
+      std::cerr << "Usage: " << argv[0]
+                << " [--scales 1,100,10000] [--warmup N] [--repetitions N]"
+                   " [--filter TEXT] [--seed N] [--dir DIRECTORY]"
+                   " [--json FILE] [--max-bytes-per-hero N]"
+                   " [--max-profile-bytes-per-hero N]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::string value{argv[++i]};
+    if (arg == "--scales") {
+      scales = ParseScales(value);
+    } else if (arg == "--warmup") {
+      options.warmup = static_cast<size_t>(std::stoul(value));
+    } else if (arg == "--repetitions") {
+      options.repetitions = static_cast<size_t>(std::stoul(value));
+    } else if (arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "--seed") {
+      seed = std::stoull(value);
+    } else if (arg == "--dir") {
+      directory = value;
+    } else if (arg == "--json") {
+      json = value;
+    } else if (arg == "--max-bytes-per-hero") {
+      limits.per_hero = std::stod(value);
+    } else if (arg == "--max-profile-bytes-per-hero") {
+      limits.profile_per_hero = std::stod(value);
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+#ifndef __OPTIMIZE__
+  std::cerr << "Warning: the benchmarks weren't built with optimisation, e.g. "
+               "-DCMAKE_BUILD_TYPE=Release."
+            << std::endl;
+#endif
+
+  std::vector<Benchmark::Result> results{};
+  bool within_limits{true};
+  try {
+    MakeDirectory(directory);
+    Benchmark::PrintHeadings(std::cout);
+    for (size_t scale : scales) {
+      std::string data_dir = directory + "/x" + std::to_string(scale);
+      MakeDirectory(data_dir);
+      // the real data has about 10 draws and 3 events
+      Generator::Options generate{};
+      generate.seed = seed;
+      generate.heroes = REAL_HEROES * scale;
+      generate.draws = 10 * scale;
+      generate.events = 3 * scale;
+      Generator::Generate(data_dir, generate);
+      within_limits &= RunAll(data_dir, scale, options, limits, results);
+    }
+  } catch (std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream file{json};
+  file << Benchmark::ToJSON(results);
+  if (!file.good()) {
+    std::cerr << "Could not write " << json << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << std::endl << "Results written to " << json << std::endl;
+  return within_limits ? EXIT_SUCCESS : EXIT_FAILURE;
+}
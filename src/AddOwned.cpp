@@ -1,27 +1,169 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "AddOwned.h"
+#include "Catalog.h"
 #include "Hero.h"
-#include "Heroes.h"
+#include "Journal.h"
 #include "Menu.h"
+#include "Schema.h"
+#include "Search.h"
+#include "Stats.h"
 #include "Utilities.h"
+#include "Views.h"
 
 namespace AddOwned {
-void UpdateFile() {
-  // open heroes.csv and owned.csv data files
-  std::string DATA_DIR = "../data";
-  std::ifstream ifile{DATA_DIR + "/heroes.csv"};
-  std::ofstream ofile{DATA_DIR + "/owned.csv"};
+namespace {
+/** @brief The names of the upgrades, indexed by Hero::Upgradeable */
+const std::array<const char *, Hero::UPGRADES_COUNT> UPGRADE_NAMES{
+    {"grade", "level", "stars", "unique", "ultimate"}};
+
+/** @brief The most heroes named when a name matches several */
+constexpr size_t MAX_SUGGESTIONS{5};
+
+/**
+ * @return the words of a text in lowercase. Words are separated by anything
+ * except letters and numbers, e.g. "Sunshine" Holy Knight Escanor has the
+ * words sunshine, holy, knight and escanor.
+ */
+std::vector<std::string> Words(const std::string &text) {
+  std::vector<std::string> words{};
+  std::string word{};
+  for (char ch : text) {
+    unsigned char byte = static_cast<unsigned char>(ch);
+    // bytes of UTF-8 characters are kept as they are
+    if (std::isalnum(byte) || byte >= 0x80) {
+      word += static_cast<char>(std::tolower(byte));
+    } else if (!word.empty()) {
+      words.push_back(word);
+      word.clear();
+    }
+  }
+  if (!word.empty()) {
+    words.push_back(word);
+  }
+  return words;
+}
+
+/**
+ * @brief An index of the words of every hero's name, so the heroes a word
+ * starts one of their words are found with a binary search. Make it once to
+ * find many heroes; it's only valid while the catalog has the same heroes.
+ */
+class NameIndex {
+public:
+  explicit NameIndex(const Catalog &catalog) : catalog{catalog}, words{} {
+    for (const Hero &hero : catalog.list) {
+      for (std::string &word : Words(hero.hero)) {
+        words.emplace_back(std::move(word), hero.index);
+      }
+    }
+    std::sort(words.begin(), words.end());
+  }
+
+  /**
+   * @brief Finds a hero from its name, part of it or an abbreviation of it.
+   * @see ParseImport
+   * @param &text The name
+   * @return the hero's index in Catalog::list
+   * @throw std::invalid_argument if no hero or more than one matches
+   */
+  size_t Find(const std::string &text) const {
+    auto exact = catalog.names.find(text);
+    if (exact != catalog.names.end()) {
+      return exact->second;
+    }
+    std::vector<std::string> query = Words(text);
+    if (query.empty()) {
+      throw std::invalid_argument("There is no hero name.");
+    }
+
+    // the heroes with a word starting with each word of the text
+    std::vector<size_t> matches{};
+    for (size_t i{0}; i < query.size(); i++) {
+      std::vector<size_t> heroes{};
+      for (auto it = std::lower_bound(words.begin(), words.end(),
+                                      std::make_pair(query[i], size_t{0}));
+           it != words.end() &&
+           it->first.compare(0, query[i].size(), query[i]) == 0;
+           it++) {
+        heroes.push_back(it->second);
+      }
+      std::sort(heroes.begin(), heroes.end());
+      heroes.erase(std::unique(heroes.begin(), heroes.end()), heroes.end());
+      if (i == 0) {
+        matches = std::move(heroes);
+      } else {
+        std::vector<size_t> both{};
+        std::set_intersection(matches.begin(), matches.end(), heroes.begin(),
+                              heroes.end(), std::back_inserter(both));
+        matches = std::move(both);
+      }
+    }
+
+    if (matches.size() > 1) {
+      // e.g. Queen Diane is both a hero's name and part of another's
+      std::vector<size_t> named{};
+      for (size_t index : matches) {
+        if (Words(catalog.list[index].name) == query) {
+          named.push_back(index);
+        }
+      }
+      if (named.size() == 1) {
+        return named[0];
+      }
+    }
+    if (matches.empty()) {
+      // the search index corrects typos, e.g. Meliodsa
+      std::string names{};
+      for (const Search::Suggestion &suggestion :
+           catalog.search.Suggest(text, MAX_SUGGESTIONS, Search::HERO)) {
+        names += (names.empty() ? " Did you mean " : "; ") +
+                 suggestion.text.str();
+      }
+      throw std::invalid_argument("No hero matches " + text + "." + names +
+                                  (names.empty() ? "" : "?"));
+    }
+    if (matches.size() > 1) {
+      std::string names{};
+      for (size_t i{0}; i < matches.size() && i < MAX_SUGGESTIONS; i++) {
+        names += (i == 0 ? "" : "; ") + catalog.list[matches[i]].hero.str();
+      }
+      throw std::invalid_argument(
+          text + " matches " + std::to_string(matches.size()) +
+          " heroes, e.g. " + names + ". Please write more of the name.");
+    }
+    return matches[0];
+  }
+
+private:
+  const Catalog &catalog;
+  /** @brief Every word of every hero's name, and the hero's index, sorted */
+  std::vector<std::pair<std::string, size_t>> words;
+};
+} // namespace
+
+void UpdateFile(Catalog &catalog) {
+  STATS_TIMER("AddOwned/UpdateFile");
+  // open heroes.csv data file, and make the contents of owned.csv
+  std::ifstream ifile{catalog.data_dir + "/heroes.csv"};
+  std::string contents{};
 
   std::string line;
-  for (auto &hero : Heroes::list) {
+  for (auto &hero : catalog.list) {
     std::getline(ifile, line);
     // add empty lines in the places heroes.csv has empty lines
     if (Utilities::EmptyCSV(line)) {
-      ofile << ",,,,,\n";
+      contents += ",,,,,\n";
       std::getline(ifile, line);
     }
 
@@ -34,48 +176,59 @@ void UpdateFile() {
     vec_data.insert(vec_data.begin(),
                     hero.hero); // insert hero name at start of vec_data
     std::string csv_data = Utilities::MakeCSV(vec_data);
-    ofile << csv_data << "\n";
+    contents += csv_data + "\n";
   }
+
+  // replace owned.csv in one step, so a crash can't leave half a file
+  Utilities::WriteFileAtomically(catalog.data_dir + "/owned.csv", contents);
+  STATS_COUNT("AddOwned/UpdateFile bytes written", contents.size());
+  catalog.version++;
 }
 
-void UpdateHero(Hero &hero) {
-  // hero data needs initialised if not already owned
-  if (!hero.owned) {
-    hero.owned = true;
-  }
+void UpdateHero(Catalog &catalog, Hero &hero) {
+  // the answers go in a copy of the hero, which replaces it once it's saved,
+  // so the hero is unchanged if the update can't be saved
+  Hero updated = hero;
+  updated.owned = true;
 
   size_t input{};
 
   // ask for and set all data
   std::vector<std::string> grades{"R", "SR", "SSR", "UR", "LR"};
   input = Menu::AskForInput("Please select hero's grade.", grades);
-  hero.upgrades[Hero::GRADE] = grades[input - 1];
+  updated.upgrades[Hero::GRADE] = grades[input - 1];
 
   std::vector<std::string> levels{"30", "40", "50", "60", "65", "70",
                                   "75", "80", "85", "90", "95", "100"};
   input = Menu::AskForInput("Please select hero's maximum level.", levels);
-  hero.upgrades[Hero::LEVEL] = levels[input - 1];
+  updated.upgrades[Hero::LEVEL] = levels[input - 1];
 
   std::vector<std::string> stars{"0", "1", "2", "3",  "4",  "5", "6",
                                  "7", "8", "9", "10", "11", "12"};
   input = Menu::AskForInput("Please select hero's awakening stars.", stars);
-  hero.upgrades[Hero::STARS] = stars[input - 1];
+  updated.upgrades[Hero::STARS] = stars[input - 1];
 
   std::vector<std::string> uniques{"true", "false"};
   input = Menu::AskForInput(
       "Please select whether hero has unlocked their unique ability.", uniques);
-  hero.upgrades[Hero::UNIQUE] = uniques[input - 1];
+  updated.upgrades[Hero::UNIQUE] = uniques[input - 1];
 
   std::vector<std::string> ultimates{"1", "2", "3", "4", "5", "6"};
   input = Menu::AskForInput("Please select the hero's ultimate move level.",
                             ultimates);
-  hero.upgrades[Hero::ULTIMATE] = ultimates[input - 1];
+  updated.upgrades[Hero::ULTIMATE] = ultimates[input - 1];
+
+  // save the update, then keep the saved views up to date, and the cached
+  // results out of date
+  Journal::Append(catalog, updated);
+  hero = updated;
+  Views::Update(catalog, hero);
+  catalog.version++;
 }
 
-void UpdateHeroes(
-    const std::vector<std::array<Hero, Heroes::COUNT>::iterator> &list) {
-  for (const auto &it : list) {
-    auto &hero = *it;
+void UpdateHeroes(Catalog &catalog, const std::vector<size_t> &list) {
+  for (size_t index : list) {
+    Hero &hero = catalog.list[index];
     std::cout << hero.hero << ":" << std::endl;
 
     bool update{};
@@ -89,8 +242,143 @@ void UpdateHeroes(
     }
 
     if (update) {
-      UpdateHero(hero);
+      UpdateHero(catalog, hero);
+    }
+  }
+}
+
+std::vector<Change> ParseImport(const Catalog &catalog,
+                                const std::vector<std::string> &lines,
+                                const std::string &source_name) {
+  STATS_TIMER("AddOwned/ParseImport");
+  const NameIndex index{catalog};
+  std::vector<Change> changes{};
+  std::vector<std::string> errors{};
+  // the line each hero is on, to find heroes listed twice
+  std::unordered_map<size_t, size_t> lines_of_heroes{};
+  for (size_t i{0}; i < lines.size(); i++) {
+    if (Utilities::EmptyCSV(Utilities::Trim(lines[i]))) {
+      continue;
+    }
+    const std::string line_name = "Line " + std::to_string(i + 1) + ": ";
+    std::vector<std::string> data = Utilities::ParseCSV(lines[i]);
+    // names with commas don't need to be quoted, e.g. Thor, the God of Thunder
+    while (data.size() > Hero::UPGRADES_COUNT + 1) {
+      data[0] += "," + data[1];
+      data.erase(data.begin() + 1);
+    }
+    for (std::string &item : data) {
+      item = Utilities::Trim(item);
+    }
+    if (data.size() != Hero::UPGRADES_COUNT + 1) {
+      errors.push_back(line_name + "has " + std::to_string(data.size()) +
+                       " items instead of " +
+                       std::to_string(Hero::UPGRADES_COUNT + 1) +
+                       ": hero, grade, level, stars, unique, ultimate.");
+      continue;
+    }
+
+    size_t hero_index{0};
+    try {
+      hero_index = index.Find(data[0]);
+    } catch (std::invalid_argument &ex) {
+      errors.push_back(line_name + ex.what());
+      continue;
+    }
+    const Hero &hero = catalog.list[hero_index];
+    data[0] = hero.hero;
+    std::string &grade = data[1 + Hero::GRADE];
+    std::transform(grade.begin(), grade.end(), grade.begin(), ::toupper);
+    std::string &unique = data[1 + Hero::UNIQUE];
+    std::transform(unique.begin(), unique.end(), unique.begin(), ::tolower);
+    if (unique == "yes" || unique == "y") {
+      unique = "true";
+    } else if (unique == "no" || unique == "n") {
+      unique = "false";
+    }
+
+    std::vector<std::string> line_errors{};
+    if (!Hero::UpgradesSchema::Validate(data, line_errors)) {
+      for (const std::string &error : line_errors) {
+        errors.push_back(line_name + error);
+      }
+      continue;
+    }
+    auto seen = lines_of_heroes.emplace(hero_index, i + 1);
+    if (!seen.second) {
+      errors.push_back(line_name + hero.hero.str() + " is also on line " +
+                       std::to_string(seen.first->second) + ".");
+      continue;
+    }
+
+    Change change{hero_index, hero.owned, hero.upgrades, {}};
+    std::copy_n(data.begin() + 1, Hero::UPGRADES_COUNT, change.after.begin());
+    if (!hero.owned || change.before != change.after) {
+      changes.push_back(change);
+    }
+  }
+  if (!errors.empty()) {
+    throw std::runtime_error(Schema::Report(source_name, errors));
+  }
+
+  std::sort(changes.begin(), changes.end(),
+            [](const Change &lhs, const Change &rhs) {
+              return lhs.index < rhs.index;
+            });
+  return changes;
+}
+
+void PrintChanges(std::ostream &os, const Catalog &catalog,
+                  const std::vector<Change> &changes) {
+  size_t added{0};
+  for (const Change &change : changes) {
+    os << (change.was_owned ? "~ " : "+ ") << catalog.list[change.index].hero
+       << ":";
+    std::string separator{" "};
+    for (size_t i{0}; i < Hero::UPGRADES_COUNT; i++) {
+      if (!change.was_owned) {
+        os << separator << UPGRADE_NAMES[i] << " " << change.after[i];
+      } else if (change.before[i] != change.after[i]) {
+        os << separator << UPGRADE_NAMES[i] << " " << change.before[i]
+           << " -> " << change.after[i];
+      } else {
+        continue;
+      }
+      separator = ", ";
+    }
+    os << "\n";
+    added += !change.was_owned;
+  }
+  os << added << " heroes added to owned, and " << changes.size() - added
+     << " owned heroes changed." << std::endl;
+}
+
+void ApplyImport(Catalog &catalog, const std::vector<Change> &changes) {
+  STATS_TIMER("AddOwned/ApplyImport");
+  if (changes.empty()) {
+    return;
+  }
+  for (const Change &change : changes) {
+    Hero &hero = catalog.list[change.index];
+    hero.owned = true;
+    hero.upgrades = change.after;
+    Views::Update(catalog, hero);
+  }
+
+  // one write of owned.csv saves every change, and anything in the journal.
+  // If it fails, the heroes are put back as they were.
+  try {
+    UpdateFile(catalog);
+  } catch (const std::runtime_error &) {
+    for (const Change &change : changes) {
+      Hero &hero = catalog.list[change.index];
+      hero.owned = change.was_owned;
+      hero.upgrades = change.before;
+      Views::Update(catalog, hero);
     }
+    catalog.version++;
+    throw;
   }
+  Journal::Clear(catalog);
 }
-} // namespace AddOwned
\ No newline at end of file
+} // namespace AddOwned
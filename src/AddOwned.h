@@ -6,27 +6,97 @@
 
 #pragma once
 #include "Hero.h"
-#include "Heroes.h"
+#include <array>
+#include <iostream>
+#include <string>
 #include <vector>
 
+struct Catalog;
+
 namespace AddOwned {
+/** @brief A change to an owned hero, made by importing a list */
+struct Change {
+  /** @brief the hero's index in Catalog::list */
+  size_t index;
+  /** @brief whether the hero was owned, and its upgrades, before and after */
+  bool was_owned;
+  std::array<std::string, Hero::UPGRADES_COUNT> before;
+  std::array<std::string, Hero::UPGRADES_COUNT> after;
+};
+
 /**
- * @brief (Over)writes file data/owned.csv using current Hero::heroes data.
+ * @brief (Over)writes file data/owned.csv using the catalog's heroes. The
+ * file is replaced in one step, so it is never left partly written.
+ * @throw std::runtime_error if the file can't be written
+ * @param &catalog The catalog
+ * @see Journal::Compact
  */
-void UpdateFile();
+void UpdateFile(Catalog &catalog);
 
 /**
- * @brief Ask for hero's upgrades and update it.
+ * @brief Ask for hero's upgrades and update it. The update is saved in the
+ * journal straight away.
+ * @see Journal::Append
+ * @param &catalog The catalog the hero is in
  * @param &hero Reference to the hero object to be updated.
+ * @throw std::runtime_error if the update can't be saved; the hero is then
+ * left as it was
  */
-void UpdateHero(Hero &hero);
+void UpdateHero(Catalog &catalog, Hero &hero);
 
 /**
  * @brief Used to AddOwned. Go through a list of heroes in order. Choose yes/no
  * whether to update each one.
- * @param list The list of heroes to update.
+ * @param &catalog The catalog
+ * @param &list The indices in Catalog::list of the heroes to update.
  * @todo print upgrades
  */
-void UpdateHeroes(
-    const std::vector<std::array<Hero, Heroes::COUNT>::iterator> &list);
+void UpdateHeroes(Catalog &catalog, const std::vector<size_t> &list);
+
+/**
+ * @brief Reads a list of owned heroes, e.g. pasted or from a file, and works
+ * out how it changes them. Each line is hero, grade, level, stars, unique,
+ * ultimate, like owned.csv, e.g. tavern master mel, UR, 80, 6, yes, 6.
+ * Grades are in any case and unique can also be yes or no. Empty lines are
+ * skipped. Every line is checked before anything changes.
+ *
+ * The hero is found from its name, part of it or an abbreviation of it. The
+ * whole name, e.g. [Boar Hat] Tavern Master Meliodas, is found as it is.
+ * Otherwise every word must start a word of exactly one hero's name, e.g.
+ * boar hat mel or tavern master mel; case and punctuation don't matter. If
+ * several heroes match, one whose name without the title (e.g. Tavern Master
+ * Meliodas) is the text is chosen, if there's only one.
+ * @param &catalog The catalog
+ * @param &lines The lines of the list
+ * @param &source_name The list's name in error messages, e.g. a file name
+ * @return the changes, in the order of Catalog::list, without heroes that
+ * don't change
+ * @throw std::runtime_error listing every invalid line (see Schema::Report),
+ * including heroes that are listed twice
+ */
+std::vector<Change> ParseImport(const Catalog &catalog,
+                                const std::vector<std::string> &lines,
+                                const std::string &source_name);
+
+/**
+ * @brief Prints the changes made by an import: + for heroes added to owned,
+ * ~ for heroes whose upgrades change, with the old and new value of each
+ * upgrade that changes.
+ * @param &os Where to print them
+ * @param &catalog The catalog
+ * @param &changes The changes
+ */
+void PrintChanges(std::ostream &os, const Catalog &catalog,
+                  const std::vector<Change> &changes);
+
+/**
+ * @brief Makes the changes of an import, and saves them all with one write
+ * of data/owned.csv, which also empties the journal.
+ * @param &catalog The catalog
+ * @param &changes The changes, from ParseImport
+ * @throw std::runtime_error if owned.csv can't be written, and the heroes
+ * are then left as they were, or if the journal can't be emptied
+ * @see Journal::Clear
+ */
+void ApplyImport(Catalog &catalog, const std::vector<Change> &changes);
 } // namespace AddOwned
\ No newline at end of file
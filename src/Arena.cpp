@@ -0,0 +1,179 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arena.h"
+
+namespace {
+/** @return the FNV-1a hash of some characters */
+size_t Hash(const char *ptr, size_t length) {
+  uint64_t hash{14695981039346656037ULL};
+  for (size_t i{0}; i < length; i++) {
+    hash ^= static_cast<unsigned char>(ptr[i]);
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<size_t>(hash);
+}
+} // namespace
+
+constexpr size_t Arena::BLOCK_SIZE;
+
+Arena::Arena()
+    : mutex{}, blocks{}, next{nullptr}, left{0}, bytes{0},
+      interned(256, Text{nullptr, 0}), interned_count{0}, parent{nullptr} {}
+
+Arena::Arena(Arena &parent)
+    : mutex{}, blocks{}, next{nullptr}, left{0}, bytes{0},
+      interned(256, Text{nullptr, 0}), interned_count{0}, parent{&parent} {
+  // take the free part of the parent's block, so a single child doesn't use
+  // any more blocks than the parent would have
+  std::lock_guard<std::mutex> lock{parent.mutex};
+  std::swap(next, parent.next);
+  std::swap(left, parent.left);
+}
+
+void *Arena::Allocate(size_t size, size_t alignment) {
+  std::lock_guard<std::mutex> lock{mutex};
+  return AllocateLocked(size, alignment);
+}
+
+void *Arena::AllocateLocked(size_t size, size_t alignment) {
+  size_t padding = (alignment - reinterpret_cast<uintptr_t>(next) % alignment) %
+                   alignment;
+  if (next == nullptr || padding + size > left) {
+    // anything too big for a block gets a block of its own, so the rest of the
+    // current block isn't wasted
+    if (size + alignment > BLOCK_SIZE) {
+      char *block = NewBlock(size + alignment);
+      padding = (alignment - reinterpret_cast<uintptr_t>(block) % alignment) %
+                alignment;
+      bytes += size;
+      return block + padding;
+    }
+    next = NewBlock(BLOCK_SIZE);
+    left = BLOCK_SIZE;
+    padding = (alignment - reinterpret_cast<uintptr_t>(next) % alignment) %
+              alignment;
+  }
+  char *out = next + padding;
+  next += padding + size;
+  left -= padding + size;
+  bytes += size;
+  return out;
+}
+
+char *Arena::NewBlock(size_t size) {
+  if (parent != nullptr) {
+    std::lock_guard<std::mutex> lock{parent->mutex};
+    parent->blocks.emplace_back(new char[size]);
+    return parent->blocks.back().get();
+  }
+  blocks.emplace_back(new char[size]);
+  return blocks.back().get();
+}
+
+Text Arena::Intern(const std::string &str) {
+  std::lock_guard<std::mutex> lock{mutex};
+  size_t slot = FindLocked(str.data(), str.size());
+  if (interned[slot].data() != nullptr) {
+    return interned[slot];
+  }
+
+  char *ptr = static_cast<char *>(AllocateLocked(str.size(), 1));
+  std::memcpy(ptr, str.data(), str.size());
+  Text out{ptr, str.size()};
+  InsertLocked(slot, out);
+  return out;
+}
+
+void Arena::Merge(Arena &other) {
+  if (&other == this) {
+    return;
+  }
+  if (other.parent != nullptr && other.parent != this) {
+    throw std::invalid_argument("Only a child arena can be merged into its "
+                                "parent.");
+  }
+  std::lock(mutex, other.mutex);
+  std::lock_guard<std::mutex> lock{mutex, std::adopt_lock};
+  std::lock_guard<std::mutex> other_lock{other.mutex, std::adopt_lock};
+
+  // keep the bigger table and add the other's texts to it, so the fewest
+  // strings are hashed again
+  if (interned_count < other.interned_count) {
+    interned.swap(other.interned);
+    std::swap(interned_count, other.interned_count);
+  }
+  for (const Text &text : other.interned) {
+    if (text.data() == nullptr) {
+      continue;
+    }
+    size_t slot = FindLocked(text.data(), text.size());
+    if (interned[slot].data() == nullptr) {
+      InsertLocked(slot, text);
+    }
+  }
+
+  // carry on from whichever block has the most left, e.g. a single child's
+  for (auto &block : other.blocks) {
+    blocks.push_back(std::move(block));
+  }
+  if (other.left > left) {
+    next = other.next;
+    left = other.left;
+  }
+  bytes += other.bytes;
+  other.blocks.clear();
+  other.next = nullptr;
+  other.left = 0;
+  other.bytes = 0;
+  other.interned.assign(256, Text{nullptr, 0});
+  other.interned_count = 0;
+}
+
+size_t Arena::FindLocked(const char *ptr, size_t length) const {
+  size_t mask = interned.size() - 1;
+  size_t slot = Hash(ptr, length) & mask;
+  while (interned[slot].data() != nullptr &&
+         !(interned[slot] == Text{ptr, length})) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void Arena::InsertLocked(size_t slot, const Text &text) {
+  interned[slot] = text;
+  interned_count++;
+
+  // keep the table at most half full, so probing stays short
+  if (interned_count * 2 > interned.size()) {
+    std::vector<Text> table(interned.size() * 2, Text{nullptr, 0});
+    size_t mask = table.size() - 1;
+    for (const Text &item : interned) {
+      if (item.data() == nullptr) {
+        continue;
+      }
+      size_t index = Hash(item.data(), item.size()) & mask;
+      while (table[index].data() != nullptr) {
+        index = (index + 1) & mask;
+      }
+      table[index] = item;
+    }
+    interned.swap(table);
+  }
+}
+
+size_t Arena::Blocks() const {
+  std::lock_guard<std::mutex> lock{mutex};
+  return blocks.size();
+}
+
+size_t Arena::Bytes() const {
+  std::lock_guard<std::mutex> lock{mutex};
+  return bytes;
+}
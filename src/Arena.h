@@ -0,0 +1,206 @@
+/**
+ * @file Arena.h
+ * @brief Declares Arena class, which allocates the data made from the data
+ * files, and the Text and Span handles into it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An unchangeable string stored in an Arena. It's only a pointer and a
+ * size, so it's cheap to copy, but it's only valid while its arena exists.
+ */
+class Text {
+public:
+  /** @brief An empty text */
+  Text() : ptr{""}, length{0} {}
+
+  /**
+   * @param *ptr The characters, which must stay valid as long as the text
+   * @param length The number of characters
+   */
+  Text(const char *ptr, size_t length) : ptr{ptr}, length{length} {}
+
+  const char *data() const { return ptr; }
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+  const char *begin() const { return ptr; }
+  const char *end() const { return ptr + length; }
+
+  /** @brief Copies the text into a std::string */
+  std::string str() const { return std::string{ptr, length}; }
+  operator std::string() const { return str(); }
+
+private:
+  const char *ptr;
+  size_t length;
+};
+
+inline bool operator==(const Text &lhs, const Text &rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+inline bool operator==(const Text &lhs, const std::string &rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+inline bool operator==(const std::string &lhs, const Text &rhs) {
+  return rhs == lhs;
+}
+inline bool operator==(const Text &lhs, const char *rhs) {
+  return lhs == Text{rhs, std::strlen(rhs)};
+}
+template <typename T> bool operator!=(const Text &lhs, const T &rhs) {
+  return !(lhs == rhs);
+}
+inline bool operator!=(const std::string &lhs, const Text &rhs) {
+  return !(rhs == lhs);
+}
+
+inline std::ostream &operator<<(std::ostream &os, const Text &text) {
+  return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+/**
+ * @brief An unchangeable list stored in an Arena. Like Text, it's only a
+ * pointer and a size.
+ */
+template <typename T> class Span {
+public:
+  Span() : ptr{nullptr}, length{0} {}
+  Span(const T *ptr, size_t length) : ptr{ptr}, length{length} {}
+
+  const T *begin() const { return ptr; }
+  const T *end() const { return ptr + length; }
+  size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+  const T &operator[](size_t i) const { return ptr[i]; }
+
+private:
+  const T *ptr;
+  size_t length;
+};
+
+/**
+ * @brief Prints the elements of a span separated by commas, like
+ * Utilities::operator<< for vectors.
+ */
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const Span<T> &span) {
+  for (size_t i{0}; i < span.size(); i++) {
+    os << (i == 0 ? "" : ", ") << span[i];
+  }
+  return os;
+}
+
+/**
+ * @brief A monotonic allocator: memory is taken from large blocks in order,
+ * and is only released when the whole arena is destroyed. Each dataset has
+ * one for the strings and lists of its heroes, so making a dataset needs a
+ * handful of allocations, and replacing one releases all of it at once. It's
+ * safe to use from several threads.
+ */
+class Arena {
+public:
+  /** @brief The size of each block of memory */
+  static constexpr size_t BLOCK_SIZE{64 * 1024};
+
+  Arena();
+
+  /**
+   * @brief Makes an arena that takes its memory from a parent arena, a block
+   * at a time, but interns strings on its own until it's merged into the
+   * parent. A thread can use it without waiting for others that use the
+   * parent. Its first allocations go in the free part of the parent's block.
+   * @param &parent The parent, which must outlive it
+   */
+  explicit Arena(Arena &parent);
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Allocates memory that stays valid as long as the arena.
+   * @param size The number of bytes
+   * @param alignment The alignment, a power of 2
+   * @return the memory
+   */
+  void *Allocate(size_t size, size_t alignment);
+
+  /**
+   * @brief Stores a string once: interning a string equal to one interned
+   * before returns the same text.
+   * @param &str The string
+   * @return the text in the arena
+   */
+  Text Intern(const std::string &str);
+
+  /**
+   * @brief Copies a list into the arena.
+   * @param &vec The list. T must be trivially copyable, e.g. Text.
+   * @return the list in the arena
+   */
+  template <typename T> Span<T> Copy(const std::vector<T> &vec) {
+    if (vec.empty()) {
+      return Span<T>{};
+    }
+    T *out = static_cast<T *>(Allocate(vec.size() * sizeof(T), alignof(T)));
+    std::memcpy(out, vec.data(), vec.size() * sizeof(T));
+    return Span<T>{out, vec.size()};
+  }
+
+  /**
+   * @brief Moves the memory and interned strings of another arena into this
+   * one, e.g. a child arena one thread used. Its texts and spans stay valid as
+   * long as this arena. A string both arenas interned stays as two copies,
+   * and Intern returns one of them from then on.
+   * @param &other The other arena, which is left empty. It must be a child of
+   * this arena, or have no parent.
+   * @throw std::invalid_argument if other is a child of another arena
+   */
+  void Merge(Arena &other);
+
+  /** @brief The number of blocks allocated */
+  size_t Blocks() const;
+
+  /** @brief The number of bytes used, not counting the rest of the blocks */
+  size_t Bytes() const;
+
+private:
+  /** @brief Allocate, with mutex already locked */
+  void *AllocateLocked(size_t size, size_t alignment);
+
+  /** @brief Adds a block of memory, to the parent's blocks if there is one */
+  char *NewBlock(size_t size);
+
+  /**
+   * @brief Finds the slot of a string in interned, or the empty slot where it
+   * goes, with mutex already locked
+   */
+  size_t FindLocked(const char *ptr, size_t length) const;
+
+  /** @brief Puts a text in an empty slot of interned, and grows interned if
+   * it's more than half full, with mutex already locked */
+  void InsertLocked(size_t slot, const Text &text);
+
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<char[]>> blocks;
+  /** @brief The free part of the last block */
+  char *next;
+  size_t left;
+  size_t bytes;
+  /** @brief An open addressing hash table of the interned strings. Its size
+   * is a power of 2, and at most half of it is used. */
+  std::vector<Text> interned;
+  size_t interned_count;
+  /** @brief The arena the blocks are taken from, or nullptr */
+  Arena *parent;
+};
@@ -0,0 +1,180 @@
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Cache.h"
+#include "Catalog.h"
+#include "Filter.h"
+#include "Heroes.h"
+#include "Journal.h"
+#include "Stats.h"
+#include "Views.h"
+#include "sdsgc.h"
+
+struct sdsgc_catalog {
+  Catalog catalog;
+};
+
+struct sdsgc_query {
+  sdsgc_catalog *catalog;
+  Filter::Expression expression;
+  /** @brief expression compiled once, for when its result isn't cached */
+  Filter::Condition condition;
+};
+
+namespace {
+/** @brief The message about the last error in each thread */
+thread_local std::string last_error{};
+
+/**
+ * @brief Calls function, turning exceptions into a status, so that none
+ * cross the C interface.
+ * @param error The status for std::runtime_error and std::invalid_argument
+ */
+template <typename Function>
+sdsgc_status Guard(sdsgc_status error, Function function) {
+  last_error.clear();
+  try {
+    function();
+    return SDSGC_OK;
+  } catch (const std::invalid_argument &ex) {
+    last_error = ex.what();
+    return error;
+  } catch (const std::runtime_error &ex) {
+    last_error = ex.what();
+    return error;
+  } catch (const std::exception &ex) {
+    last_error = ex.what();
+    return SDSGC_INTERNAL_ERROR;
+  } catch (...) {
+    last_error = "Unknown error";
+    return SDSGC_INTERNAL_ERROR;
+  }
+}
+
+/** @brief Sets the last error for a null or out of range argument */
+sdsgc_status InvalidArgument(const std::string &message) {
+  last_error = message;
+  return SDSGC_INVALID_ARGUMENT;
+}
+} // namespace
+
+extern "C" {
+const char *sdsgc_last_error(void) { return last_error.c_str(); }
+
+sdsgc_status sdsgc_catalog_open(const char *data_dir,
+                                sdsgc_catalog **catalog) {
+  if (data_dir == nullptr || catalog == nullptr) {
+    return InvalidArgument("data_dir and catalog must not be null");
+  }
+  *catalog = nullptr;
+  return Guard(SDSGC_INVALID_DATA, [data_dir, catalog]() {
+    std::unique_ptr<sdsgc_catalog> out{new sdsgc_catalog{Catalog{data_dir}}};
+    Heroes::MakeHeroes(out->catalog);
+    *catalog = out.release();
+  });
+}
+
+void sdsgc_catalog_close(sdsgc_catalog *catalog) { delete catalog; }
+
+size_t sdsgc_catalog_notice_count(const sdsgc_catalog *catalog) {
+  return catalog == nullptr ? 0 : catalog->catalog.notices.size();
+}
+
+const char *sdsgc_catalog_notice(const sdsgc_catalog *catalog, size_t index) {
+  if (catalog == nullptr || index >= catalog->catalog.notices.size()) {
+    return nullptr;
+  }
+  return catalog->catalog.notices[index].c_str();
+}
+
+sdsgc_status sdsgc_catalog_recover(sdsgc_catalog *catalog) {
+  if (catalog == nullptr) {
+    return InvalidArgument("catalog must not be null");
+  }
+  return Guard(SDSGC_INVALID_DATA,
+               [catalog]() { Journal::Recover(catalog->catalog); });
+}
+
+size_t sdsgc_catalog_size(const sdsgc_catalog *catalog) {
+  return catalog == nullptr ? 0 : catalog->catalog.list.size();
+}
+
+const char *sdsgc_hero_name(const sdsgc_catalog *catalog, size_t row) {
+  if (catalog == nullptr || row >= catalog->catalog.list.size()) {
+    return nullptr;
+  }
+  // Text isn't terminated, but the name index has each name as a string
+  return catalog->catalog.names.find(catalog->catalog.list[row].hero)
+      ->first.c_str();
+}
+
+sdsgc_status sdsgc_catalog_load_profile(sdsgc_catalog *catalog,
+                                        const char *filename) {
+  if (catalog == nullptr || filename == nullptr) {
+    return InvalidArgument("catalog and filename must not be null");
+  }
+  return Guard(SDSGC_INVALID_DATA, [catalog, filename]() {
+    Heroes::LoadProfile(catalog->catalog, filename);
+    Views::Refresh(catalog->catalog);
+  });
+}
+
+sdsgc_status sdsgc_query_compile(sdsgc_catalog *catalog, const char *text,
+                                 sdsgc_query **query) {
+  if (catalog == nullptr || text == nullptr || query == nullptr) {
+    return InvalidArgument("catalog, text and query must not be null");
+  }
+  *query = nullptr;
+  return Guard(SDSGC_INVALID_QUERY, [catalog, text, query]() {
+    Filter::Expression expression = Filter::Normalize(Filter::Parse(text));
+    // compile it now, so an invalid filter is reported here
+    Filter::Condition condition = Filter::Compile(catalog->catalog, expression);
+    *query = new sdsgc_query{catalog, expression, condition};
+  });
+}
+
+void sdsgc_query_free(sdsgc_query *query) { delete query; }
+
+sdsgc_status sdsgc_query_evaluate(sdsgc_query *query, size_t *rows,
+                                  size_t capacity, size_t *count) {
+  if (query == nullptr || count == nullptr ||
+      (rows == nullptr && capacity > 0)) {
+    return InvalidArgument("query and count must not be null, and rows must "
+                           "not be null unless capacity is 0");
+  }
+  *count = 0;
+  return Guard(SDSGC_INVALID_QUERY, [query, rows, capacity, count]() {
+    std::shared_ptr<const std::vector<bool>> result =
+        Cache::Evaluate(query->catalog->catalog, query->expression,
+                        query->condition);
+    size_t found{0};
+    for (size_t i{0}; i < result->size(); i++) {
+      if ((*result)[i]) {
+        if (found < capacity) {
+          rows[found] = i;
+        }
+        found++;
+      }
+    }
+    *count = found;
+  });
+}
+
+void sdsgc_stats_enable(int enabled) { Stats::Enable(enabled != 0); }
+
+void sdsgc_stats_reset(void) { Stats::Reset(); }
+
+size_t sdsgc_stats_dump(char *buffer, size_t capacity) {
+  std::string json = Stats::ToJSON();
+  if (buffer != nullptr && capacity > 0) {
+    size_t length = json.size() < capacity ? json.size() : capacity - 1;
+    std::memcpy(buffer, json.data(), length);
+    buffer[length] = '\0';
+  }
+  return json.size();
+}
+} // extern "C"
@@ -0,0 +1,146 @@
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Cache.h"
+#include "Catalog.h"
+#include "Filter.h"
+#include "Hero.h"
+#include "Memory.h"
+#include "Stats.h"
+
+namespace Cache {
+
+namespace {
+void Evict(Store &store, size_t bytes) {
+  while (!store.entries.empty() &&
+         store.statistics.bytes + bytes > store.statistics.capacity) {
+    const Entry &entry = store.entries.back();
+    store.statistics.bytes -= entry.bytes;
+    store.statistics.evictions++;
+    store.keys.erase(entry.key);
+    store.entries.pop_back();
+  }
+  store.statistics.entries = store.entries.size();
+}
+
+/** @return the key of the result of a filter, for a version of the heroes */
+std::string Key(const Filter::Expression &expression, size_t version) {
+  return Filter::ToString(Filter::Normalize(expression)) + "@" +
+         std::to_string(version);
+}
+
+/** @brief Removes the results of older versions of the heroes, which are
+ * never used again */
+void Update(Catalog &catalog) {
+  Store &store = catalog.cache;
+  if (store.version != catalog.version) {
+    Clear(store);
+    store.version = catalog.version;
+  }
+}
+
+/** @brief Adds a result with its key, if it fits */
+void Add(Store &store, const std::string &key,
+         const std::shared_ptr<const std::vector<bool>> &rows) {
+  // the key is stored twice; the rest is an estimate of the containers' nodes
+  size_t bytes = 2 * key.size() + (rows->size() + 7) / 8 + sizeof(Entry) +
+                 sizeof(std::vector<bool>) + 64;
+  if (bytes <= store.statistics.capacity && store.keys.count(key) == 0) {
+    Evict(store, bytes);
+    store.entries.push_front({key, rows, bytes});
+    store.keys[key] = store.entries.begin();
+    store.statistics.bytes += bytes;
+    store.statistics.entries = store.entries.size();
+  }
+}
+} // namespace
+
+Store::Store()
+    : entries{}, keys{}, version{0},
+      statistics{0, 0, 0, 0, 0, DEFAULT_CAPACITY} {}
+
+namespace {
+/**
+ * @brief Evaluates a filter, or finds its cached result
+ * @param make Called on a cache miss, for the compiled filter
+ */
+template <typename Make>
+std::shared_ptr<const std::vector<bool>>
+Run(Catalog &catalog, const Filter::Expression &expression, Make make) {
+  STATS_TIMER("Cache/Evaluate");
+  Store &store = catalog.cache;
+  Update(catalog);
+
+  std::string key = Key(expression, store.version);
+  auto found = store.keys.find(key);
+  if (found != store.keys.end()) {
+    // move to the front, as it's now the most recently used
+    store.entries.splice(store.entries.begin(), store.entries, found->second);
+    store.statistics.hits++;
+    STATS_COUNT("Cache/hits", 1);
+    return found->second->rows;
+  }
+  store.statistics.misses++;
+  STATS_COUNT("Cache/misses", 1);
+
+  STATS_TIMER("Cache/evaluate a filter");
+  MEMORY_PHASE("Cache/evaluate a filter");
+  const Filter::Condition &condition = make();
+  std::shared_ptr<std::vector<bool>> rows =
+      std::make_shared<std::vector<bool>>(catalog.list.size(), false);
+  for (size_t i{0}; i < catalog.list.size(); i++) {
+    (*rows)[i] = condition(catalog.list[i]);
+  }
+
+  Add(store, key, rows);
+  return rows;
+}
+} // namespace
+
+std::shared_ptr<const std::vector<bool>>
+Evaluate(Catalog &catalog, const Filter::Expression &expression) {
+  return Run(catalog, expression,
+             [&catalog, &expression]() -> Filter::Condition {
+               return Filter::Compile(catalog, expression);
+             });
+}
+
+std::shared_ptr<const std::vector<bool>>
+Evaluate(Catalog &catalog, const Filter::Expression &expression,
+         const Filter::Condition &condition) {
+  return Run(catalog, expression,
+             [&condition]() -> const Filter::Condition & { return condition; });
+}
+
+void Insert(Catalog &catalog, const Filter::Expression &expression,
+            const std::shared_ptr<const std::vector<bool>> &rows) {
+  Update(catalog);
+  Add(catalog.cache, Key(expression, catalog.version), rows);
+}
+
+std::shared_ptr<const std::vector<bool>>
+Find(const Catalog &catalog, const Filter::Expression &expression) {
+  const Store &store = catalog.cache;
+  if (store.version != catalog.version) {
+    return nullptr;
+  }
+  auto found = store.keys.find(Key(expression, store.version));
+  return found == store.keys.end() ? nullptr : found->second->rows;
+}
+
+void SetCapacity(Store &store, size_t bytes) {
+  store.statistics.capacity = bytes;
+  Evict(store, 0);
+}
+
+void Clear(Store &store) {
+  store.entries.clear();
+  store.keys.clear();
+  store.statistics.bytes = 0;
+  store.statistics.entries = 0;
+}
+} // namespace Cache
@@ -0,0 +1,132 @@
+/**
+ * @file Cache.h
+ * @brief Cache namespace keeps the results of recently used filters, so that
+ * filters that are used again don't need to be evaluated again.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Filter.h"
+
+struct Catalog;
+
+/**
+ * @brief Cache namespace keeps the results of recently used filters, so that
+ * filters that are used again don't need to be evaluated again.
+ */
+namespace Cache {
+
+/** @brief The default size of the cache in bytes */
+static constexpr size_t DEFAULT_CAPACITY{4 * 1024 * 1024};
+
+/** @brief Statistics lets you see how well the cache is working */
+struct Statistics {
+  /** @brief the number of filters that were found in the cache */
+  size_t hits;
+  /** @brief the number of filters that had to be evaluated */
+  size_t misses;
+  /** @brief the number of results removed to make space */
+  size_t evictions;
+  /** @brief the number of results in the cache */
+  size_t entries;
+  /** @brief the memory used by the cache in bytes */
+  size_t bytes;
+  /** @brief the maximum memory the cache can use in bytes */
+  size_t capacity;
+
+  /** @return the fraction of filters that were found in the cache */
+  double HitRate() const {
+    return hits + misses == 0
+               ? 0.0
+               : static_cast<double>(hits) / static_cast<double>(hits + misses);
+  }
+};
+
+/** @brief A cached result */
+struct Entry {
+  /** @brief the normalized filter and the version of the heroes */
+  std::string key;
+  std::shared_ptr<const std::vector<bool>> rows;
+  /** @brief an estimate of the memory used by the entry */
+  size_t bytes;
+};
+
+/** @brief Store is a cache; each catalog has its own. */
+struct Store {
+  Store();
+
+  /** @brief the entries, most recently used first */
+  std::list<Entry> entries;
+  /** @brief the entries by key */
+  std::unordered_map<std::string, std::list<Entry>::iterator> keys;
+  /** @brief the version of the heroes the entries are for */
+  size_t version;
+  Statistics statistics;
+};
+
+/**
+ * @brief Evaluates a filter, using the cached result if the same filter (after
+ * Filter::Normalize) was evaluated since the heroes last changed. Results of
+ * older versions of the heroes (see Catalog::version) are removed first.
+ * @param &catalog The catalog whose heroes and cache are used
+ * @param &expression A filter
+ * @return whether each hero is in the result, indexed by Hero::index
+ * @throw std::invalid_argument if the filter is invalid
+ */
+std::shared_ptr<const std::vector<bool>>
+Evaluate(Catalog &catalog, const Filter::Expression &expression);
+
+/**
+ * @brief Evaluate, with the filter already compiled, so that a filter that's
+ * evaluated many times is only compiled once.
+ * @param &catalog The catalog whose heroes and cache are used
+ * @param &expression A filter
+ * @param &condition expression, compiled for catalog by Filter::Compile
+ * @return whether each hero is in the result, indexed by Hero::index
+ */
+std::shared_ptr<const std::vector<bool>>
+Evaluate(Catalog &catalog, const Filter::Expression &expression,
+         const Filter::Condition &condition);
+
+/**
+ * @brief Adds the result of a filter evaluated some other way, e.g. by a
+ * Cursor, to the cache, unless it's already there.
+ * @param &catalog The catalog whose cache is used
+ * @param &expression A filter
+ * @param &rows Whether each hero is in the result, for the current version of
+ * the heroes
+ */
+void Insert(Catalog &catalog, const Filter::Expression &expression,
+            const std::shared_ptr<const std::vector<bool>> &rows);
+
+/**
+ * @brief Looks up the cached result of a filter, without evaluating it or
+ * changing the statistics or which results are most recently used.
+ * @param &catalog The catalog whose cache is used
+ * @param &expression A filter
+ * @return the result, or nullptr if it isn't cached for the current version of
+ * the heroes
+ */
+std::shared_ptr<const std::vector<bool>>
+Find(const Catalog &catalog, const Filter::Expression &expression);
+
+/**
+ * @brief Changes the maximum memory the cache can use, removing the least
+ * recently used results if needed.
+ * @param &store The cache
+ * @param bytes The new size of the cache in bytes
+ */
+void SetCapacity(Store &store, size_t bytes);
+
+/**
+ * @brief Removes every result from the cache
+ * @param &store The cache
+ */
+void Clear(Store &store);
+} // namespace Cache
@@ -0,0 +1,15 @@
+#include <string>
+
+#include "Catalog.h"
+#include "Reload.h"
+
+Catalog::Catalog(const std::string &data_dir)
+    : data_dir{data_dir}, list{}, arena{}, acquisition_methods{},
+      method_heroes{}, names{}, tier_lists{}, search{}, titles{}, headings{},
+      revision{0}, version{0}, cache{}, views{}, journal_records{0},
+      journal_torn{false}, notices{}, watcher{} {}
+
+// the watcher is only a complete type here
+Catalog::~Catalog() = default;
+Catalog::Catalog(Catalog &&) = default;
+Catalog &Catalog::operator=(Catalog &&) = default;
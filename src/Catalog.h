@@ -0,0 +1,112 @@
+/**
+ * @file Catalog.h
+ * @brief Declares Catalog struct, which holds a set of heroes and everything
+ * the program keeps about them.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+#include "Cache.h"
+#include "Hero.h"
+#include "Search.h"
+#include "TierLists.h"
+#include "Trigrams.h"
+#include "Views.h"
+
+namespace Reload {
+class Watcher;
+} // namespace Reload
+
+/**
+ * @brief A catalog is one set of heroes read from one data directory, with
+ * its indexes, tier lists, cached filter results and saved views. Everything
+ * that uses heroes is given the catalog to use, so a program can have several
+ * catalogs, e.g. for different game regions or data versions. Catalogs made
+ * from the same dataset share its arena, which doesn't change.
+ * @see Heroes::MakeHeroes
+ * @see Heroes::Install
+ */
+struct Catalog {
+  /**
+   * @param &data_dir The directory of the data files
+   */
+  explicit Catalog(const std::string &data_dir = "../data");
+  ~Catalog();
+  Catalog(Catalog &&);
+  Catalog &operator=(Catalog &&);
+
+  /** @brief The directory of the data files, e.g. ../data */
+  std::string data_dir;
+
+  /**
+   * @brief The master list of all heroes, sized from heroes.csv when it's
+   * read. Heroes are referred to by their index in this list (Hero::index),
+   * which stays the same until a new dataset is installed.
+   */
+  std::vector<Hero> list;
+
+  /** @brief The arena the information of the heroes in list is stored in.
+   * It's released when the heroes are replaced, unless another catalog uses
+   * it too. */
+  std::shared_ptr<Arena> arena;
+
+  /** @brief The headings in acquisition.txt and draws.txt */
+  std::vector<std::string> acquisition_methods;
+
+  /** @brief The indices in list of the heroes of each of acquisition_methods,
+   * in order */
+  std::vector<std::vector<size_t>> method_heroes;
+
+  /** @brief The index in list of every hero: { Hero name => index, ... } */
+  std::unordered_map<std::string, size_t> names;
+
+  /** @brief All the registered tier lists, with each hero's latest tier */
+  std::vector<TierLists::TierList> tier_lists;
+
+  /** @brief The search index of the heroes' names and characters */
+  Search::Index search;
+
+  /** @brief The trigram index of every hero's name (Hero::hero), in the
+   * order of list */
+  Trigrams::Index titles;
+
+  /** @brief The trigram index of acquisition_methods, in the same order */
+  Trigrams::Index headings;
+
+  /** @brief The newest revision number of any tier list */
+  size_t revision;
+
+  /** @brief A counter that changes every time any hero data changes, e.g.
+   * when the data files are read or an owned hero is updated. Anything
+   * computed from the heroes is out of date if it was computed for a
+   * different version. */
+  size_t version;
+
+  /** @brief The results of recently used filters */
+  Cache::Store cache;
+
+  /** @brief The saved views */
+  std::vector<Views::View> views;
+
+  /** @brief The number of records in owned.journal */
+  size_t journal_records;
+
+  /** @brief Whether owned.journal ends with a partly written record, which
+   * Journal::Replay ignored */
+  bool journal_torn;
+
+  /** @brief Messages for the user about the data files, from the last time
+   * they were read, e.g. that there's no owned.csv. The program prints them,
+   * and the library passes them on. */
+  std::vector<std::string> notices;
+
+  /** @brief Watches the data directory, if Reload::Watcher::Start was
+   * called */
+  std::unique_ptr<Reload::Watcher> watcher;
+};
@@ -0,0 +1,75 @@
+#include <memory>
+#include <vector>
+
+#include "Cache.h"
+#include "Catalog.h"
+#include "Cursor.h"
+#include "Filter.h"
+#include "Hero.h"
+#include "Stats.h"
+
+Cursor::Cursor(Catalog &catalog, const Filter::Expression &expression,
+               size_t offset)
+    : catalog{catalog}, expression{expression},
+      cached{Cache::Find(catalog, expression)}, condition{}, rows{},
+      version{catalog.version}, position{0}, found{0}, skip{offset},
+      has_ahead{false}, ahead{0} {
+  if (!cached) {
+    condition = Filter::Compile(catalog, expression);
+    rows = std::make_shared<std::vector<bool>>(catalog.list.size(), false);
+  }
+}
+
+bool Cursor::Next(size_t &index) {
+  Advance();
+  if (!has_ahead) {
+    return false;
+  }
+  index = ahead;
+  has_ahead = false;
+  return true;
+}
+
+std::vector<size_t> Cursor::Take(size_t count) {
+  std::vector<size_t> out{};
+  size_t index{0};
+  while (out.size() < count && Next(index)) {
+    out.push_back(index);
+  }
+  return out;
+}
+
+bool Cursor::Done() {
+  Advance();
+  return !has_ahead;
+}
+
+void Cursor::Advance() {
+  const size_t size = catalog.list.size();
+  const size_t start{position};
+  while (!has_ahead && position < size) {
+    size_t i = position++;
+    if (cached ? !(*cached)[i] : !condition(catalog.list[i])) {
+      continue;
+    }
+    if (rows) {
+      (*rows)[i] = true;
+    }
+    found++;
+    if (skip > 0) {
+      skip--;
+      continue;
+    }
+    has_ahead = true;
+    ahead = i;
+  }
+  STATS_COUNT("Cursor/heroes checked", position - start);
+
+  // the whole result is known now, so filters after this can use it
+  if (position == size && rows) {
+    if (version == catalog.version) {
+      Cache::Insert(catalog, expression, rows);
+    }
+    rows.reset();
+  }
+}
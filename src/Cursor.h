@@ -0,0 +1,81 @@
+/**
+ * @file Cursor.h
+ * @brief Declares Cursor class, which finds the heroes a filter matches one at
+ * a time, as they're needed.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Filter.h"
+
+struct Catalog;
+
+/**
+ * @brief A cursor finds the heroes a filter matches in order, only checking
+ * heroes until it has found as many as are asked for, so the first results of
+ * a broad filter come straight away however many heroes there are. If the
+ * result is cached, the cache is used instead. A cursor that reaches the end
+ * adds the result to the cache. The heroes mustn't change while a cursor is
+ * used.
+ */
+class Cursor {
+public:
+  /**
+   * @param &catalog The catalog to filter
+   * @param &expression A filter
+   * @param offset The number of matching heroes to skip
+   * @throw std::invalid_argument if the filter is invalid
+   */
+  Cursor(Catalog &catalog, const Filter::Expression &expression,
+         size_t offset = 0);
+
+  /**
+   * @brief Finds the next matching hero.
+   * @param &index Set to the hero's index in Catalog::list, if there is one
+   * @return whether there was another matching hero
+   */
+  bool Next(size_t &index);
+
+  /**
+   * @param count The most heroes to find
+   * @return the indices of the next count matching heroes, or fewer if there
+   * aren't that many left
+   */
+  std::vector<size_t> Take(size_t count);
+
+  /** @return whether there are no more matching heroes. It checks heroes
+   * until it finds the next one. */
+  bool Done();
+
+  /** @return the number of heroes checked so far */
+  size_t Checked() const { return position; }
+
+  /** @return the number of matching heroes found so far, including those
+   * skipped */
+  size_t Found() const { return found; }
+
+private:
+  /** @brief Checks heroes until the next match, and keeps it in ahead */
+  void Advance();
+
+  Catalog &catalog;
+  Filter::Expression expression;
+  /** @brief The cached result, or nullptr if the heroes are being checked */
+  std::shared_ptr<const std::vector<bool>> cached;
+  Filter::Condition condition;
+  /** @brief Whether each hero checked so far matched, for the cache */
+  std::shared_ptr<std::vector<bool>> rows;
+  /** @brief The version of the heroes when the cursor was made */
+  size_t version;
+  /** @brief The index of the next hero to check */
+  size_t position;
+  size_t found;
+  size_t skip;
+  /** @brief Whether ahead is the next match, found by Done */
+  bool has_ahead;
+  size_t ahead;
+};
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Catalog.h"
+#include "Diff.h"
+#include "Hero.h"
+#include "Heroes.h"
+#include "Stats.h"
+#include "Utilities.h"
+
+namespace Diff {
+namespace {
+/** @brief The names of the upgrades, indexed by Hero::Upgradeable */
+const std::array<const char *, Hero::UPGRADES_COUNT> UPGRADE_NAMES{
+    {"grade", "level", "stars", "unique", "ultimate"}};
+
+/** @brief The names of the kinds of differences, in the order of Kind */
+const std::array<const char *, 3> KIND_NAMES{{"added", "removed", "changed"}};
+
+/** @brief The fewest pairs of files compared in a thread of their own */
+constexpr size_t MIN_PAIRS_PER_THREAD{16};
+} // namespace
+
+Snapshot Current(const Catalog &catalog) {
+  Snapshot snapshot{};
+  for (const Hero &hero : catalog.list) {
+    if (hero.owned) {
+      snapshot.push_back({hero.index, hero.upgrades});
+    }
+  }
+  return snapshot;
+}
+
+Snapshot Read(const Catalog &catalog, const std::string &filename) {
+  STATS_TIMER("Diff/Read");
+  if (!std::ifstream{filename}.good()) {
+    throw std::runtime_error("Could not open " + filename + ".");
+  }
+  auto upgrades = Heroes::ReadProfile(filename);
+  Snapshot snapshot(upgrades.size());
+  bool sorted{true};
+  for (size_t i{0}; i < upgrades.size(); i++) {
+    auto found = catalog.names.find(upgrades[i].first);
+    if (found == catalog.names.end()) {
+      throw std::runtime_error("Hero name " + upgrades[i].first + " in " +
+                               filename + " was not found in heroes.csv.");
+    }
+    snapshot[i] = {found->second, std::move(upgrades[i].second)};
+    sorted = sorted && (i == 0 || snapshot[i - 1].index < found->second);
+  }
+  if (sorted) {
+    return snapshot;
+  }
+
+  // later records replace earlier ones: the sort is stable, so the last
+  // record of each hero is the last of its run
+  std::stable_sort(snapshot.begin(), snapshot.end(),
+                   [](const Owned &lhs, const Owned &rhs) {
+                     return lhs.index < rhs.index;
+                   });
+  size_t kept{0};
+  for (size_t i{0}; i < snapshot.size(); i++) {
+    if (i + 1 < snapshot.size() &&
+        snapshot[i + 1].index == snapshot[i].index) {
+      continue;
+    }
+    if (kept != i) {
+      snapshot[kept] = std::move(snapshot[i]);
+    }
+    kept++;
+  }
+  snapshot.resize(kept);
+  return snapshot;
+}
+
+std::vector<Difference> Compare(const Snapshot &before,
+                                const Snapshot &after) {
+  STATS_TIMER("Diff/Compare");
+  std::vector<Difference> differences{};
+  size_t i{0};
+  size_t j{0};
+  while (i < before.size() || j < after.size()) {
+    if (j == after.size() ||
+        (i < before.size() && before[i].index < after[j].index)) {
+      differences.push_back(
+          {before[i].index, Kind::REMOVED, before[i].upgrades, {}});
+      i++;
+    } else if (i == before.size() || after[j].index < before[i].index) {
+      differences.push_back(
+          {after[j].index, Kind::ADDED, {}, after[j].upgrades});
+      j++;
+    } else {
+      if (before[i].upgrades != after[j].upgrades) {
+        differences.push_back({before[i].index, Kind::CHANGED,
+                               before[i].upgrades, after[j].upgrades});
+      }
+      i++;
+      j++;
+    }
+  }
+  return differences;
+}
+
+std::vector<Result>
+CompareFiles(const Catalog &catalog,
+             const std::vector<std::pair<std::string, std::string>> &pairs) {
+  STATS_TIMER("Diff/CompareFiles");
+  std::vector<Result> results(pairs.size());
+  Utilities::ParallelFor(
+      pairs.size(),
+      [&catalog, &pairs, &results](size_t begin, size_t end) {
+        for (size_t i{begin}; i < end; i++) {
+          try {
+            results[i].differences =
+                Compare(Read(catalog, pairs[i].first),
+                        Read(catalog, pairs[i].second));
+          } catch (std::exception &ex) {
+            results[i].error = ex.what();
+          }
+        }
+      },
+      MIN_PAIRS_PER_THREAD);
+  return results;
+}
+
+void Print(std::ostream &os, const Catalog &catalog,
+           const std::vector<Difference> &differences) {
+  std::array<size_t, KIND_NAMES.size()> counts{};
+  std::string out{};
+  for (const Difference &difference : differences) {
+    counts[static_cast<size_t>(difference.kind)]++;
+    out += difference.kind == Kind::ADDED     ? "+ "
+           : difference.kind == Kind::REMOVED ? "- "
+                                              : "~ ";
+    out += catalog.list[difference.index].hero.str() + ":";
+    std::string separator{" "};
+    for (size_t i{0}; i < Hero::UPGRADES_COUNT; i++) {
+      if (difference.kind == Kind::ADDED) {
+        out += separator + UPGRADE_NAMES[i] + " " + difference.after[i];
+      } else if (difference.kind == Kind::REMOVED) {
+        out += separator + UPGRADE_NAMES[i] + " " + difference.before[i];
+      } else if (difference.before[i] != difference.after[i]) {
+        out += separator + UPGRADE_NAMES[i] + " " + difference.before[i] +
+               " -> " + difference.after[i];
+      } else {
+        continue;
+      }
+      separator = ", ";
+    }
+    out += "\n";
+  }
+  os << out << counts[0] << " heroes added, " << counts[1] << " removed and "
+     << counts[2] << " changed." << std::endl;
+}
+
+std::vector<std::vector<std::string>>
+Rows(const Catalog &catalog, const std::vector<Difference> &differences) {
+  std::vector<std::vector<std::string>> rows{};
+  for (const Difference &difference : differences) {
+    for (size_t i{0}; i < Hero::UPGRADES_COUNT; i++) {
+      if (difference.before[i] != difference.after[i]) {
+        rows.push_back({catalog.list[difference.index].hero.str(),
+                        KIND_NAMES[static_cast<size_t>(difference.kind)],
+                        UPGRADE_NAMES[i], difference.before[i],
+                        difference.after[i]});
+      }
+    }
+  }
+  return rows;
+}
+} // namespace Diff
@@ -0,0 +1,128 @@
+/**
+ * @file Diff.h
+ * @brief Diff namespace compares two sets of owned heroes, e.g. owned.csv
+ * before and after a sync, or the profiles of two accounts.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Hero.h"
+
+struct Catalog;
+
+/**
+ * @brief Diff namespace compares snapshots of the owned heroes: which heroes
+ * one has that the other doesn't, and which upgrades of the heroes both have
+ * are different. A snapshot is kept in the order of Catalog::list, so two are
+ * compared by walking them side by side, in time linear in their sizes.
+ */
+namespace Diff {
+
+/** @brief An owned hero in a snapshot */
+struct Owned {
+  /** @brief the hero's index in Catalog::list */
+  size_t index;
+  std::array<std::string, Hero::UPGRADES_COUNT> upgrades;
+};
+
+/** @brief Owned heroes, in the order of Catalog::list, each once */
+using Snapshot = std::vector<Owned>;
+
+/** @brief How a hero differs between two snapshots */
+enum class Kind { ADDED, REMOVED, CHANGED };
+
+/** @brief A hero that differs between two snapshots */
+struct Difference {
+  /** @brief the hero's index in Catalog::list */
+  size_t index;
+  /** @brief ADDED if only the second snapshot has it, REMOVED if only the
+   * first one does, or CHANGED if its upgrades are different */
+  Kind kind;
+  /** @brief the hero's upgrades in each snapshot, empty if it doesn't have
+   * the hero */
+  std::array<std::string, Hero::UPGRADES_COUNT> before;
+  std::array<std::string, Hero::UPGRADES_COUNT> after;
+};
+
+/** @brief The differences between two snapshot files, or why they couldn't
+ * be compared */
+struct Result {
+  std::vector<Difference> differences;
+  /** @brief the error, or empty */
+  std::string error;
+};
+
+/**
+ * @param &catalog The catalog
+ * @return the catalog's owned heroes
+ */
+Snapshot Current(const Catalog &catalog);
+
+/**
+ * @brief Reads a snapshot from a file in the format of owned.csv. Like
+ * Heroes::LoadProfile, later records of a hero replace earlier ones. Files
+ * in the order of heroes.csv, as owned.csv is written, aren't sorted.
+ * @param &catalog The catalog, to find the heroes in
+ * @param &filename The file
+ * @return the snapshot
+ * @throw std::runtime_error if a record has invalid data or an unrecognised
+ * hero name
+ * @see Heroes::ReadProfile
+ */
+Snapshot Read(const Catalog &catalog, const std::string &filename);
+
+/**
+ * @brief Compares two snapshots, in one pass over both.
+ * @param &before The first snapshot, e.g. owned.csv before a sync
+ * @param &after The second snapshot
+ * @return the heroes that differ, in the order of Catalog::list
+ */
+std::vector<Difference> Compare(const Snapshot &before,
+                                const Snapshot &after);
+
+/**
+ * @brief Reads and compares pairs of snapshot files, e.g. thousands of
+ * accounts before and after a sync, several pairs at a time in separate
+ * threads. A pair with an invalid file has an error instead of differences,
+ * and doesn't stop the others.
+ * @param &catalog The catalog
+ * @param &pairs The files of each pair, first the one compared from
+ * @return the result of each pair, in the same order
+ */
+std::vector<Result>
+CompareFiles(const Catalog &catalog,
+             const std::vector<std::pair<std::string, std::string>> &pairs);
+
+/**
+ * @brief Prints differences like AddOwned::PrintChanges: + for heroes added,
+ * - for heroes removed, ~ for heroes whose upgrades changed, with the old and
+ * new value of each upgrade that changed, then how many of each there are.
+ * @param &os Where to print them
+ * @param &catalog The catalog
+ * @param &differences The differences
+ */
+void Print(std::ostream &os, const Catalog &catalog,
+           const std::vector<Difference> &differences);
+
+/** @brief The headings of Rows */
+const std::vector<std::string> headings = {"Hero", "Change", "Upgrade",
+                                           "Before", "After"};
+
+/**
+ * @brief Makes a row for each upgrade that differs, e.g. [Boar Hat] Tavern
+ * Master Meliodas, changed, grade, SSR, UR, for writing with
+ * Render::WriteTable. Added and removed heroes have a row for every upgrade.
+ * @param &catalog The catalog
+ * @param &differences The differences
+ * @return the rows, with a cell for each of headings
+ */
+std::vector<std::vector<std::string>>
+Rows(const Catalog &catalog, const std::vector<Difference> &differences);
+} // namespace Diff
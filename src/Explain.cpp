@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Cache.h"
+#include "Catalog.h"
+#include "Explain.h"
+#include "Filter.h"
+#include "Hero.h"
+
+namespace Explain {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/** @brief The width of the node column, including indentation */
+constexpr size_t NAME_WIDTH{40};
+
+/** @brief The number of times each node is timed */
+constexpr size_t TIMING_RUNS{3};
+
+/** @return the nanoseconds since start */
+uint64_t Since(Clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                           start)
+          .count());
+}
+
+/** @brief The conditions that find their heroes with an index, when they're
+ * compiled, rather than checking each hero */
+const std::array<const char *, 2> INDEXED{{"HeroContains", "MethodContains"}};
+
+/** @return the nodes of a filter, not yet run */
+Node MakeNode(const Filter::Expression &expression, Access access) {
+  bool indexed = std::find_if(INDEXED.begin(), INDEXED.end(),
+                              [&expression](const char *name) {
+                                return expression.name == name;
+                              }) != INDEXED.end();
+  Node node{expression.children.empty() ? Filter::ToString(expression)
+                                        : expression.name,
+            indexed && access == Access::SCAN ? Access::INDEX : access, 0, 0,
+            0, 0, 0, {}};
+  for (const Filter::Expression &child : expression.children) {
+    node.children.push_back(MakeNode(child, access));
+  }
+  return node;
+}
+
+/**
+ * @brief Estimates the heroes given to and found by each node. Conditions
+ * check evenly spaced heroes; operations assume their conditions are
+ * independent.
+ * @param in The estimated number of heroes given to the node
+ */
+void Estimate(const Catalog &catalog, const Filter::Expression &expression,
+              Node &node, double in) {
+  node.estimated_in = in;
+  if (expression.children.empty()) {
+    Filter::Condition condition =
+        Filter::Compile(catalog, expression, Filter::Wrapper{});
+    size_t sample = std::min(SAMPLE_SIZE, catalog.list.size());
+    size_t found{0};
+    for (size_t i{0}; i < sample; i++) {
+      found += condition(catalog.list[i * catalog.list.size() / sample]);
+    }
+    node.estimated_out = sample == 0 ? 0.0
+                                     : in * static_cast<double>(found) /
+                                           static_cast<double>(sample);
+    return;
+  }
+
+  // And only checks a condition for the heroes the ones before it found, and
+  // Or for the heroes they didn't
+  double remaining{in};
+  for (size_t i{0}; i < expression.children.size(); i++) {
+    Node &child = node.children[i];
+    Estimate(catalog, expression.children[i], child, remaining);
+    if (expression.name == "And") {
+      remaining = child.estimated_out;
+    } else if (expression.name == "Or") {
+      remaining -= child.estimated_out;
+    }
+  }
+  if (expression.name == "And") {
+    node.estimated_out = remaining;
+  } else if (expression.name == "Or") {
+    node.estimated_out = in - remaining;
+  } else if (expression.name == "Not") {
+    node.estimated_out = in - node.children[0].estimated_out;
+  } else {
+    node.estimated_out = in;
+  }
+}
+
+/** @brief Finds the node of each expression of a filter */
+void IndexNodes(const Filter::Expression &expression, Node &node,
+                std::unordered_map<const Filter::Expression *, Node *> &out) {
+  out[&expression] = &node;
+  for (size_t i{0}; i < expression.children.size(); i++) {
+    IndexNodes(expression.children[i], node.children[i], out);
+  }
+}
+
+/**
+ * @brief Times each node checking the heroes that were given to it, without
+ * counting, which would slow it down.
+ * @param &inputs The heroes given to each node: { Expression => whether each
+ * hero was given to it }
+ */
+void Time(const Catalog &catalog, const Filter::Expression &expression,
+          Node &node,
+          const std::unordered_map<const Filter::Expression *,
+                                   std::vector<bool>> &inputs) {
+  Filter::Condition condition =
+      Filter::Compile(catalog, expression, Filter::Wrapper{});
+  const std::vector<bool> &input = inputs.at(&expression);
+  // the fastest of a few runs, since the first is slowed by cold caches
+  for (size_t run{0}; run < TIMING_RUNS; run++) {
+    size_t found{0};
+    Clock::time_point start = Clock::now();
+    for (size_t i{0}; i < input.size(); i++) {
+      if (input[i]) {
+        found += condition(catalog.list[i]);
+      }
+    }
+    uint64_t nanoseconds = Since(start);
+    node.nanoseconds =
+        run == 0 ? nanoseconds : std::min(node.nanoseconds, nanoseconds);
+    // use the result, so the loop isn't optimised away
+    volatile size_t sink = found;
+    (void)sink;
+  }
+
+  for (size_t i{0}; i < expression.children.size(); i++) {
+    Time(catalog, expression.children[i], node.children[i], inputs);
+  }
+}
+
+/** @brief Prints a node and the nodes it's applied to */
+void PrintNode(std::ostream &os, const Node &node, size_t depth) {
+  std::string name = std::string(2 * depth, ' ') + node.name;
+  if (name.size() >= NAME_WIDTH) {
+    name = name.substr(0, NAME_WIDTH - 4) + "...";
+  }
+  const char *access = node.access == Access::SCAN        ? "scan"
+                       : node.access == Access::INDEX     ? "index"
+                       : node.access == Access::CACHE_HIT ? "cache hit"
+                                                          : "not run";
+  os << std::left << std::setw(NAME_WIDTH) << name << std::setw(10) << access
+     << std::right << std::setprecision(0) << std::setw(10)
+     << node.estimated_in << std::setw(10) << node.estimated_out;
+  if (node.access == Access::NOT_RUN) {
+    os << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(12) << "-";
+  } else {
+    os << std::setw(10) << node.rows_in << std::setw(10) << node.rows_out
+       << std::setprecision(3) << std::setw(12)
+       << static_cast<double>(node.nanoseconds) / 1e6;
+  }
+  os << std::endl;
+  for (const Node &child : node.children) {
+    PrintNode(os, child, depth + 1);
+  }
+}
+} // namespace
+
+Plan Analyze(const Catalog &catalog, const Filter::Expression &expression) {
+  // check the filter is valid before anything else
+  Filter::Compile(catalog, expression, Filter::Wrapper{});
+
+  // Cache::Evaluate uses a cached result instead of evaluating anything
+  Clock::time_point start = Clock::now();
+  std::shared_ptr<const std::vector<bool>> cached =
+      Cache::Find(catalog, expression);
+  uint64_t lookup = Since(start);
+
+  Plan plan{Filter::ToString(expression), catalog.list.size(),
+            MakeNode(expression, cached ? Access::NOT_RUN : Access::SCAN)};
+  Estimate(catalog, expression, plan.root,
+           static_cast<double>(catalog.list.size()));
+  if (cached) {
+    plan.root.access = Access::CACHE_HIT;
+    plan.root.rows_in = cached->size();
+    plan.root.rows_out =
+        static_cast<size_t>(std::count(cached->begin(), cached->end(), true));
+    plan.root.nanoseconds = lookup;
+    return plan;
+  }
+
+  // count the heroes given to and found by each node
+  std::unordered_map<const Filter::Expression *, Node *> nodes{};
+  IndexNodes(expression, plan.root, nodes);
+  std::unordered_map<const Filter::Expression *, std::vector<bool>> inputs{};
+  Filter::Condition counted = Filter::Compile(
+      catalog, expression,
+      [&catalog, &nodes, &inputs](const Filter::Expression &node,
+                                  Filter::Condition compiled) {
+        Node *out = nodes.at(&node);
+        // elements of an unordered_map don't move when more are added
+        std::vector<bool> *input = &inputs[&node];
+        input->assign(catalog.list.size(), false);
+        return Filter::Condition{[compiled, out, input](const Hero &hero) {
+          (*input)[hero.index] = true;
+          out->rows_in++;
+          bool result = compiled(hero);
+          out->rows_out += result;
+          return result;
+        }};
+      });
+  for (const Hero &hero : catalog.list) {
+    counted(hero);
+  }
+
+  Time(catalog, expression, plan.root, inputs);
+  return plan;
+}
+
+void Print(std::ostream &os, const Plan &plan) {
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision();
+  os << "Plan for " << plan.filter << ", over " << plan.heroes << " heroes:"
+     << std::endl;
+  os << std::left << std::setw(NAME_WIDTH) << "node" << std::setw(10)
+     << "access" << std::right << std::setw(10) << "est. in" << std::setw(10)
+     << "est. out" << std::setw(10) << "rows in" << std::setw(10)
+     << "rows out" << std::setw(12) << "time (ms)" << std::endl;
+  os << std::fixed;
+  PrintNode(os, plan.root, 0);
+  os.flags(flags);
+  os.precision(precision);
+}
+} // namespace Explain
@@ -0,0 +1,90 @@
+/**
+ * @file Explain.h
+ * @brief Explain namespace shows how a filter is evaluated: the tree of
+ * conditions and operations as it runs, with the estimated and actual number
+ * of heroes each part checks and finds, and how long each part takes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Filter.h"
+
+struct Catalog;
+
+/**
+ * @brief Explain namespace shows how a filter is evaluated, so that slow
+ * filters, and the parts of them that make them slow, can be found.
+ */
+namespace Explain {
+
+/** @brief The most heroes checked to estimate how many a condition finds */
+static constexpr size_t SAMPLE_SIZE{128};
+
+/** @brief How the result of a node was found */
+enum class Access {
+  /** @brief checking every hero given to it */
+  SCAN,
+  /** @brief looking up the heroes in an index, e.g. HeroContains in
+   * Catalog::titles */
+  INDEX,
+  /** @brief the result of the whole filter was in the cache */
+  CACHE_HIT,
+  /** @brief not evaluated, since the result was in the cache */
+  NOT_RUN
+};
+
+/** @brief A condition or operation of a filter, and how it ran */
+struct Node {
+  /** @brief the condition with its arguments, e.g. Good(1), or the operation,
+   * e.g. And */
+  std::string name;
+  Access access;
+  /** @brief the estimated number of heroes given to it and found by it.
+   * Conditions are estimated by checking some of the heroes; operations assume
+   * their conditions are independent. */
+  double estimated_in;
+  double estimated_out;
+  /** @brief the number of heroes given to it, i.e. not already decided by the
+   * conditions before it, e.g. in And(A, B), B is only checked for heroes A
+   * found */
+  size_t rows_in;
+  /** @brief the number of heroes it found */
+  size_t rows_out;
+  /** @brief the shortest of a few times to check the heroes given to it,
+   * including the nodes it's applied to */
+  uint64_t nanoseconds;
+  std::vector<Node> children;
+};
+
+/** @brief How a filter was evaluated */
+struct Plan {
+  /** @brief the filter, as Filter::ToString writes it */
+  std::string filter;
+  /** @brief the number of heroes in the catalog */
+  size_t heroes;
+  Node root;
+};
+
+/**
+ * @brief Evaluates a filter the way Cache::Evaluate would, recording how each
+ * node runs. The cache isn't changed, and the nodes are timed separately from
+ * counting, so counting doesn't slow them down.
+ * @param &catalog The catalog to filter
+ * @param &expression A filter
+ * @return how the filter was evaluated
+ * @throw std::invalid_argument if the filter is invalid
+ */
+Plan Analyze(const Catalog &catalog, const Filter::Expression &expression);
+
+/**
+ * @brief Prints a plan as an indented table, one node on each line.
+ * @param &os Where to print it
+ * @param &plan The plan
+ */
+void Print(std::ostream &os, const Plan &plan);
+} // namespace Explain
@@ -1,26 +1,196 @@
 #include <algorithm>
+#include <cctype>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "Cache.h"
+#include "Catalog.h"
 #include "Filter.h"
 #include "Hero.h"
-#include "Heroes.h"
 #include "Menu.h"
+#include "Schema.h"
+#include "Search.h"
+#include "Stats.h"
+#include "TierLists.h"
 #include "Utilities.h"
 
 namespace Filter {
-std::vector<std::array<Hero, Heroes::COUNT>::iterator> Filter() {
+namespace {
+/** @brief The most headings shown when asking for MethodContains */
+constexpr size_t MAX_HEADINGS_SHOWN{10};
+
+/**
+ * @brief Reads the tiers a condition selects.
+ * @param &condition The condition's name, for the error message
+ * @param begin, end The tiers
+ * @return a bit for each tier, so checking a tier is one operation
+ * @throw std::invalid_argument if a tier isn't a number between 1 and
+ * Hero::MAX_TIER; 0 is for heroes that aren't on a tier list, which are never
+ * selected
+ */
+unsigned int TierBits(const std::string &condition,
+                      std::vector<std::string>::const_iterator begin,
+                      std::vector<std::string>::const_iterator end) {
+  unsigned int bits{0};
+  for (auto tier = begin; tier != end; ++tier) {
+    std::string expected{};
+    if (!Schema::IntRange<1, Hero::MAX_TIER>::Check(*tier, expected)) {
+      throw std::invalid_argument("Tier " + *tier + " of " + condition +
+                                  " should be " + expected);
+    }
+    int value{};
+    Schema::ParseInt(*tier, value);
+    bits |= 1U << value;
+  }
+  return bits;
+}
+
+/** @brief Moves pos past any spaces in text */
+void SkipSpaces(const std::string &text, size_t &pos) {
+  while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+    pos++;
+  }
+}
+
+/** @return an exception saying what's wrong with text, and where */
+std::invalid_argument ParseError(const std::string &text, size_t pos,
+                                 const std::string &problem) {
+  return std::invalid_argument("Invalid filter " + text + ": " + problem +
+                               " at character " + std::to_string(pos + 1) +
+                               ".");
+}
+
+/**
+ * @brief Reads one argument of a condition, which ends at a comma or at the
+ * bracket that closes the condition.
+ * @param &text The filter
+ * @param &pos The position of the argument. Afterwards, the position after it.
+ * @return the argument
+ */
+std::string ParseArgument(const std::string &text, size_t &pos) {
+  SkipSpaces(text, pos);
+  std::string argument{};
+  if (pos < text.size() && text[pos] == '"') {
+    // quoted like a CSV field, with quotes doubled
+    for (pos++; pos < text.size(); pos++) {
+      if (text[pos] == '"') {
+        if (pos + 1 < text.size() && text[pos + 1] == '"') {
+          argument += '"';
+          pos++;
+        } else {
+          pos++;
+          SkipSpaces(text, pos);
+          return argument;
+        }
+      } else {
+        argument += text[pos];
+      }
+    }
+    throw ParseError(text, pos, "unmatched quote");
+  }
+
+  // brackets inside an argument have to match, e.g. Character(King (Fairy))
+  size_t depth{0};
+  for (; pos < text.size(); pos++) {
+    char ch = text[pos];
+    if ((ch == ',' && depth == 0) || (ch == ')' && depth == 0)) {
+      break;
+    }
+    if (ch == '(') {
+      depth++;
+    } else if (ch == ')') {
+      depth--;
+    }
+    argument += ch;
+  }
+  size_t last = argument.find_last_not_of(" \t");
+  return last == std::string::npos ? "" : argument.substr(0, last + 1);
+}
+
+/**
+ * @brief Reads one condition or operation, including its arguments or the
+ * expressions it's applied to.
+ * @param &text The filter
+ * @param &pos The position of the expression. Afterwards, the position after
+ * it.
+ * @return the expression
+ */
+Expression ParseExpression(const std::string &text, size_t &pos) {
+  SkipSpaces(text, pos);
+  size_t start{pos};
+  while (pos < text.size() && std::isalnum(static_cast<unsigned char>(
+                                  text[pos]))) {
+    pos++;
+  }
+  if (pos == start) {
+    throw ParseError(text, pos, "expected a condition or operation");
+  }
+  Expression expression{text.substr(start, pos - start), {}, {}};
+  SkipSpaces(text, pos);
+  if (pos >= text.size() || text[pos] != '(') {
+    throw ParseError(text, pos, "expected (");
+  }
+  pos++;
+  SkipSpaces(text, pos);
+
+  // operations are applied to expressions; conditions have arguments
+  bool operation =
+      std::any_of(operations.begin(), operations.end(),
+                  [&expression](const Operation &op) {
+                    return op.name == expression.name;
+                  });
+  if (pos < text.size() && text[pos] != ')') {
+    while (true) {
+      if (operation) {
+        expression.children.push_back(ParseExpression(text, pos));
+        SkipSpaces(text, pos);
+      } else {
+        expression.arguments.push_back(ParseArgument(text, pos));
+      }
+      if (pos < text.size() && text[pos] == ',') {
+        pos++;
+        continue;
+      }
+      break;
+    }
+  }
+  if (pos >= text.size() || text[pos] != ')') {
+    throw ParseError(text, pos, "expected )");
+  }
+  pos++;
+  return expression;
+}
+} // namespace
+
+std::vector<size_t> Filter(Catalog &catalog) {
+  // the result is shared with the cache, so keep it alive while selecting
+  std::shared_ptr<const std::vector<bool>> rows =
+      Cache::Evaluate(catalog, GetFilter(catalog));
+
+  // return the final filtered list
+  std::vector<size_t> filtered = Utilities::Select(
+      catalog.list,
+      std::function<bool(const Hero &)>{
+          [&rows](const Hero &hero) { return (*rows)[hero.index]; }});
+  std::cout << "\nFound: " << filtered.size() << " out of "
+            << catalog.list.size() << " heroes." << std::endl;
+  return filtered;
+}
+
+Expression GetFilter(const Catalog &catalog) {
   // initialise queue of conditions and get initial condition from user
   std::queue<std::string> filters{};
-  Condition condition = GetCondition(filters);
+  Expression expression = GetCondition(catalog, filters);
 
   // applies as many additional operations (e.g. AND) as they want
   bool sentinel_finished = false;
   while (!sentinel_finished) {
-    condition = GetOperation(condition, sentinel_finished, filters);
+    expression = GetOperation(catalog, expression, sentinel_finished, filters);
   }
 
   // print the final condition (strictly left-to-right) for reference
@@ -32,15 +202,134 @@ std::vector<std::array<Hero, Heroes::COUNT>::iterator> Filter() {
     std::cout << filters.front() << ") ";
     filters.pop();
   }
+  return expression;
+}
 
-  // return the final filtered list
-  auto filtered = Utilities::Select(Heroes::list, condition);
-  std::cout << "\nFound: " << filtered.size() << " out of "
-            << Heroes::list.size() << " heroes." << std::endl;
-  return filtered;
+Condition Compile(const Catalog &catalog, const Expression &expression) {
+  Wrapper wrapper{};
+#ifdef SDSGC_STATS
+  // count how many heroes each node is evaluated for (the counter's calls),
+  // and how many it's true for (its total)
+  if (Stats::Enabled()) {
+    wrapper = [](const Expression &node, Condition compiled) -> Condition {
+      Stats::Metric &metric =
+          Stats::Get("Filter/evaluations of " + node.name, false);
+      return [compiled, &metric](const Hero &hero) {
+        bool result = compiled(hero);
+        metric.count.fetch_add(1, std::memory_order_relaxed);
+        metric.total.fetch_add(result ? 1 : 0, std::memory_order_relaxed);
+        return result;
+      };
+    };
+  }
+#endif
+  return Compile(catalog, expression, wrapper);
+}
+
+Condition Compile(const Catalog &catalog, const Expression &expression,
+                  const Wrapper &wrapper) {
+  Condition compiled{};
+  if (expression.name == "All") {
+    compiled = [](const Hero &) { return true; };
+  }
+  for (const ConditionFunction &condition : conditions) {
+    if (condition.name == expression.name) {
+      compiled = condition.function(catalog, expression.arguments);
+    }
+  }
+  for (const Operation &operation : operations) {
+    if (operation.name == expression.name) {
+      std::vector<Condition> children{};
+      for (const Expression &child : expression.children) {
+        children.push_back(Compile(catalog, child, wrapper));
+      }
+      compiled = operation.function(children);
+    }
+  }
+  if (!compiled) {
+    throw std::invalid_argument("Unknown condition or operation " +
+                                expression.name);
+  }
+  return wrapper ? wrapper(expression, compiled) : compiled;
+}
+
+std::string ToString(const Expression &expression) {
+  std::string out = expression.name + "(";
+  if (expression.children.empty()) {
+    out += Utilities::MakeCSV(expression.arguments);
+  } else {
+    for (size_t i{0}; i < expression.children.size(); i++) {
+      out += (i == 0 ? "" : ", ") + ToString(expression.children[i]);
+    }
+  }
+  return out + ")";
+}
+
+Expression Parse(const std::string &text) {
+  size_t pos{0};
+  Expression expression = ParseExpression(text, pos);
+  SkipSpaces(text, pos);
+  if (pos != text.size()) {
+    throw ParseError(text, pos, "unexpected text after the filter");
+  }
+  return expression;
 }
 
-Condition GetCondition(std::queue<std::string> &filters) {
+Expression Normalize(const Expression &expression) {
+  Expression out{expression.name, {}, {}};
+
+  // remove spaces around arguments, and write numbers plainly, except where
+  // they're part of a text, e.g. 007. Numbers too big for an int are kept as
+  // they are, for the condition to reject.
+  const bool texts =
+      out.name == "HeroContains" || out.name == "MethodContains";
+  for (const std::string &argument : expression.arguments) {
+    size_t first = argument.find_first_not_of(" \t");
+    size_t last = argument.find_last_not_of(" \t");
+    std::string trimmed = first == std::string::npos
+                              ? ""
+                              : argument.substr(first, last - first + 1);
+    int value{};
+    bool number = !texts && !trimmed.empty() &&
+                  std::all_of(trimmed.begin(), trimmed.end(),
+                              [](char ch) { return ch >= '0' && ch <= '9'; }) &&
+                  Schema::ParseInt(trimmed, value);
+    out.arguments.push_back(number ? std::to_string(value) : trimmed);
+  }
+
+  // the tiers of Good and GoodAsOf, and the texts of HeroContains and
+  // MethodContains, are sets
+  size_t sets_from{out.arguments.size()};
+  if (out.name == "Good" || texts) {
+    sets_from = 0;
+  } else if (out.name == "GoodAsOf") {
+    sets_from = std::min<size_t>(2, out.arguments.size());
+  }
+  std::sort(out.arguments.begin() + static_cast<long>(sets_from),
+            out.arguments.end());
+  out.arguments.erase(std::unique(out.arguments.begin() +
+                                      static_cast<long>(sets_from),
+                                  out.arguments.end()),
+                      out.arguments.end());
+
+  for (const Expression &child : expression.children) {
+    out.children.push_back(Normalize(child));
+  }
+
+  // sort the conditions of commutative operations by their text
+  for (const Operation &operation : operations) {
+    if (operation.name == out.name && operation.commutative) {
+      std::sort(out.children.begin(), out.children.end(),
+                [](const Expression &a, const Expression &b) {
+                  return ToString(a) < ToString(b);
+                });
+    }
+  }
+  return out;
+}
+
+Expression GetCondition(const Catalog &catalog,
+                        std::queue<std::string> &filters) {
   // Ask for a condition
   size_t int_input{0};
   std::vector<std::string> condition_names{"All"};
@@ -55,16 +344,17 @@ Condition GetCondition(std::queue<std::string> &filters) {
   // Return unconditional if asked for
   if (int_input == 0) {
     filters.emplace("ALL");
-    return [](const Hero &) { return true; };
+    return {"All", {}, {}};
   } else {
     // Ask for arguments if needed, push condition to queue and return it
-    std::vector<std::string> arguments = GetArguments(int_input);
+    std::vector<std::string> arguments = GetArguments(catalog, int_input);
     filters.push(conditions[int_input - 1].name);
-    return conditions[int_input - 1].function(arguments);
+    return {conditions[int_input - 1].name, arguments, {}};
   }
 }
 
-std::vector<std::string> GetArguments(size_t int_input) {
+std::vector<std::string> GetArguments(const Catalog &catalog,
+                                      size_t int_input) {
   const ConditionFunction &condition = conditions[int_input - 1];
   if (condition.name == "Attribute") {
     std::vector<std::string> attributes{"Strength", "HP", "Speed", "Light",
@@ -74,8 +364,27 @@ std::vector<std::string> GetArguments(size_t int_input) {
     std::vector<std::string> starting_grades{"R", "SR", "SSR", "UR"};
     return AskForArguments("starting grade", starting_grades, 1);
   } else if (condition.name == "Character") {
-    return {Menu::GetFreeInput(
-        "Please enter a CORRECT character name, e.g. Meliodas")};
+    std::string character =
+        Menu::GetFreeInput("Please enter a character name, e.g. Meliodas");
+    if (!catalog.search.Find(character, Search::CHARACTER).empty()) {
+      return {character};
+    }
+    // offer the characters it's closest to, e.g. Meliodas for melodias
+    std::vector<Search::Suggestion> suggestions =
+        catalog.search.Suggest(character, 5, Search::CHARACTER);
+    if (suggestions.empty()) {
+      std::cout << "No hero has a character like " << character << "."
+                << std::endl;
+      return {character};
+    }
+    std::vector<std::string> options{};
+    for (const Search::Suggestion &suggestion : suggestions) {
+      options.push_back(suggestion.text.str());
+    }
+    size_t chosen = Menu::AskForInput("There's no character " + character +
+                                          ". Did you mean one of these?",
+                                      options);
+    return {options[chosen - 1]};
   } else if (condition.name == "Race") {
     std::vector<std::string> races{"Demon",   "Giant",   "Fairy",
                                    "Goddess", "Unknown", "Human"};
@@ -95,10 +404,54 @@ std::vector<std::string> GetArguments(size_t int_input) {
     std::cout << std::endl;
     std::vector<std::string> tiers{"1", "2", "3", "4", "5"};
     return AskForArguments("tiers", tiers, count_input);
+  } else if (condition.name == "GoodAsOf") {
+    std::vector<std::string> lists{};
+    for (const TierLists::TierList &list : catalog.tier_lists) {
+      lists.push_back(list.Name());
+    }
+    std::vector<std::string> arguments = AskForArguments("tier list", lists, 1);
+    std::cout << "Enter the revision of the tier list (0 is heroes.csv)."
+              << std::endl;
+    int revision = Menu::GetIntInput(0, static_cast<int>(catalog.revision));
+    std::cout << std::endl;
+    arguments.push_back(std::to_string(revision));
+    size_t count_input = Menu::AskForInput("Please select the NUMBER of tiers.",
+                                           {"1", "2", "3", "4", "5"});
+    std::cout << std::endl;
+    std::vector<std::string> tiers{"1", "2", "3", "4", "5"};
+    for (const std::string &tier :
+         AskForArguments("tiers", tiers, count_input)) {
+      arguments.push_back(tier);
+    }
+    return arguments;
   } else if (condition.name == "AvailableByMethod") {
-    std::string DATA_DIR = "../data";
-    return AskForArguments("acquisition method", Heroes::acquisition_methods,
+    return AskForArguments("acquisition method", catalog.acquisition_methods,
                            1);
+  } else if (condition.name == "HeroContains" ||
+             condition.name == "MethodContains") {
+    bool hero = condition.name == "HeroContains";
+    std::vector<std::string> terms{};
+    for (const std::string &term : Utilities::ParseCSV(Menu::GetFreeInput(
+             hero ? "Please enter text the hero's name contains, e.g. "
+                    "[Advent of (separate several with commas)"
+                  : "Please enter text the heading contains, e.g. "
+                    "Anniversary (separate several with commas)"))) {
+      std::string trimmed = Utilities::Trim(term);
+      if (!trimmed.empty()) {
+        terms.push_back(trimmed);
+      }
+    }
+    if (!hero) {
+      std::vector<uint32_t> found = catalog.headings.Find(terms);
+      std::cout << found.size() << " headings contain it";
+      for (size_t i{0}; i < found.size() && i < MAX_HEADINGS_SHOWN; i++) {
+        std::cout << (i == 0 ? ": " : "; ")
+                  << catalog.acquisition_methods[found[i]];
+      }
+      std::cout << (found.size() > MAX_HEADINGS_SHOWN ? "; ..." : ".")
+                << std::endl;
+    }
+    return terms;
   } else if (condition.name == "Upgraded") {
     std::cout << "Enter the minimum level of heroes you want to show."
               << std::endl;
@@ -128,8 +481,9 @@ std::vector<std::string> AskForArguments(std::string name,
   return arguments;
 }
 
-Condition GetOperation(Condition &condition, bool &sentinel_finished,
-                       std::queue<std::string> &filters) {
+Expression GetOperation(const Catalog &catalog, Expression &condition,
+                        bool &sentinel_finished,
+                        std::queue<std::string> &filters) {
   // Make list of no + operation names
   std::vector<std::string> options = {"No (get results)"};
   for (const auto &operation : operations) {
@@ -149,18 +503,19 @@ Condition GetOperation(Condition &condition, bool &sentinel_finished,
     return condition;
   } else {
     const Operation &chosen = operations[int_input - 1];
-    return HandleOperation(condition, chosen, filters);
+    return HandleOperation(catalog, condition, chosen, filters);
   }
 }
 
-Condition HandleOperation(Condition &condition, Operation operation,
-                          std::queue<std::string> &filters) {
+Expression HandleOperation(const Catalog &catalog, Expression &condition,
+                           Operation operation,
+                           std::queue<std::string> &filters) {
   if (operation.arity <= 0) {
     throw std::invalid_argument(
         "Invalid operation, must have positive 'arity'");
   }
   // initialise list of conditions to be operated on
-  std::vector<Condition> conditions(operation.arity);
+  std::vector<Expression> conditions(operation.arity);
 
   // add operation to filter queue
   filters.push(operation.name);
@@ -172,17 +527,18 @@ Condition HandleOperation(Condition &condition, Operation operation,
               << " other condition(s)." << std::endl;
     for (size_t i{1}; i <= operation.arity - 1; i++) {
       std::cout << i << ":" << std::endl;
-      conditions[i] = GetCondition(filters);
+      conditions[i] = GetCondition(catalog, filters);
     }
   }
 
   // return result of operation
-  return operation.function(conditions);
+  return {operation.name, {}, conditions};
 }
 
 // conditions
 
-Condition Attribute(const std::vector<std::string> &arguments) {
+Condition Attribute(const Catalog &/* catalog */,
+                    const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to Attribute should be 1 string");
   }
@@ -192,7 +548,8 @@ Condition Attribute(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition StartingGrade(const std::vector<std::string> &arguments) {
+Condition StartingGrade(const Catalog &/* catalog */,
+                        const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to StartingGrade should be 1 string");
   }
@@ -202,7 +559,8 @@ Condition StartingGrade(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition Character(const std::vector<std::string> &arguments) {
+Condition Character(const Catalog &/* catalog */,
+                    const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to Character should be 1 string");
   }
@@ -212,14 +570,16 @@ Condition Character(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition LR(const std::vector<std::string> &arguments) {
+Condition LR(const Catalog &/* catalog */,
+             const std::vector<std::string> &arguments) {
   if (arguments.size() != 0) {
     throw std::invalid_argument("Input to LR should be empty");
   }
   return [](const Hero &hero) -> bool { return hero.lr; };
 }
 
-Condition Race(const std::vector<std::string> &arguments) {
+Condition Race(const Catalog &/* catalog */,
+               const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to Race should be 1 string");
   }
@@ -230,7 +590,8 @@ Condition Race(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition Characteristic(const std::vector<std::string> &arguments) {
+Condition Characteristic(const Catalog &/* catalog */,
+                         const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to Characteristic should be 1 string");
   }
@@ -240,41 +601,73 @@ Condition Characteristic(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition Good(const std::vector<std::string> &arguments) {
+Condition Good(const Catalog &catalog,
+               const std::vector<std::string> &arguments) {
   if (arguments.size() == 0) {
     throw std::invalid_argument("Input to Good should be at least 1 string");
   }
-  const std::vector<std::string> &input_tiers = arguments;
-  return [input_tiers](const Hero &hero) -> bool {
-    return std::any_of(
-        hero.tiers.begin(), hero.tiers.end(), [input_tiers](int tier) {
-          return std::find(input_tiers.begin(), input_tiers.end(),
-                           std::to_string(tier)) != input_tiers.end();
-        });
+  unsigned int input_tiers = TierBits("Good", arguments.begin(),
+                                      arguments.end());
+  const std::vector<TierLists::TierList> &lists = catalog.tier_lists;
+  return [&lists, input_tiers](const Hero &hero) -> bool {
+    return std::any_of(lists.begin(), lists.end(),
+                       [&hero, input_tiers](const TierLists::TierList &list) {
+                         int tier = list.Latest()[hero.index];
+                         return tier > 0 && ((input_tiers >> tier) & 1U);
+                       });
+  };
+}
+
+Condition GoodAsOf(const Catalog &catalog,
+                   const std::vector<std::string> &arguments) {
+  if (arguments.size() < 3) {
+    throw std::invalid_argument(
+        "Input to GoodAsOf should be a tier list, a revision and at least 1 "
+        "tier");
+  }
+  size_t list = TierLists::Find(catalog.tier_lists, arguments.at(0));
+  int revision{};
+  if (!Schema::ParseInt(arguments.at(1), revision) || revision < 0) {
+    throw std::invalid_argument("The revision of GoodAsOf should be a number "
+                                "of at least 0, not " +
+                                arguments.at(1));
+  }
+  unsigned int input_tiers = TierBits("GoodAsOf", arguments.begin() + 2,
+                                      arguments.end());
+
+  // reconstruct the tier list once, rather than for every hero
+  std::shared_ptr<const std::vector<int>> tiers =
+      std::make_shared<const std::vector<int>>(
+          catalog.tier_lists[list].AsOf(static_cast<size_t>(revision)));
+  return [tiers, input_tiers](const Hero &hero) -> bool {
+    int tier = (*tiers)[hero.index];
+    return tier > 0 && ((input_tiers >> tier) & 1U);
   };
 }
 
-Condition AvailableByMethod(const std::vector<std::string> &arguments) {
+Condition AvailableByMethod(const Catalog &/* catalog */,
+                            const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument(
         "Input to AvailableByMethod should be 1 string");
   }
   const std::string &draw = arguments.at(0);
   return [draw](const Hero &hero) -> bool {
-    std::vector<std::string> acquisition = hero.acquisition;
-    return std::find(acquisition.begin(), acquisition.end(), draw) !=
-           acquisition.end();
+    return std::find(hero.acquisition.begin(), hero.acquisition.end(), draw) !=
+           hero.acquisition.end();
   };
 }
 
-Condition Owned(const std::vector<std::string> &arguments) {
+Condition Owned(const Catalog &/* catalog */,
+                const std::vector<std::string> &arguments) {
   if (arguments.size() != 0) {
     throw std::invalid_argument("Input to Owned should be empty");
   }
   return [](const Hero &hero) -> bool { return hero.owned; };
 }
 
-Condition Upgraded(const std::vector<std::string> &arguments) {
+Condition Upgraded(const Catalog &/* catalog */,
+                   const std::vector<std::string> &arguments) {
   if (arguments.size() != 1) {
     throw std::invalid_argument("Input to Upgraded should be 1 string");
   }
@@ -285,7 +678,40 @@ Condition Upgraded(const std::vector<std::string> &arguments) {
   };
 }
 
-Condition Acquirable(const std::vector<std::string> &arguments) {
+Condition HeroContains(const Catalog &catalog,
+                       const std::vector<std::string> &arguments) {
+  if (arguments.empty()) {
+    throw std::invalid_argument(
+        "Input to HeroContains should be at least 1 string");
+  }
+  // find the heroes once with the index, rather than searching every name
+  std::shared_ptr<std::vector<bool>> found =
+      std::make_shared<std::vector<bool>>(catalog.list.size(), false);
+  for (uint32_t index : catalog.titles.Find(arguments)) {
+    (*found)[index] = true;
+  }
+  return [found](const Hero &hero) -> bool { return (*found)[hero.index]; };
+}
+
+Condition MethodContains(const Catalog &catalog,
+                         const std::vector<std::string> &arguments) {
+  if (arguments.empty()) {
+    throw std::invalid_argument(
+        "Input to MethodContains should be at least 1 string");
+  }
+  // the heroes of each heading are known, so no hero is checked
+  std::shared_ptr<std::vector<bool>> found =
+      std::make_shared<std::vector<bool>>(catalog.list.size(), false);
+  for (uint32_t method : catalog.headings.Find(arguments)) {
+    for (size_t index : catalog.method_heroes[method]) {
+      (*found)[index] = true;
+    }
+  }
+  return [found](const Hero &hero) -> bool { return (*found)[hero.index]; };
+}
+
+Condition Acquirable(const Catalog &/* catalog */,
+                     const std::vector<std::string> &arguments) {
   if (arguments.size() != 0) {
     throw std::invalid_argument("Input to Acquirable should be empty");
   }
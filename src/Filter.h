@@ -12,19 +12,21 @@
 #include <vector>
 
 #include "Hero.h"
-#include "Heroes.h"
 #include "Menu.h"
 
+struct Catalog;
+
 namespace Filter {
 /**
  * @brief An interactive menu to filter heroes, including combining as many
  * conditions as you want. Also prints the conditions selected in the order,
  * left-to-right, that they are evaluated. (This function is called by the main
  * menu function Filter.)
- * @return a vector of iterators, pointing to the elements of the original
- * vector.
+ * @param &catalog The catalog to filter
+ * @return the indices in Catalog::list of the heroes found, in order
+ * @see GetFilter
  */
-std::vector<std::array<Hero, Heroes::COUNT>::iterator> Filter();
+std::vector<size_t> Filter(Catalog &catalog);
 
 using Condition = std::function<bool(const Hero &)>;
 
@@ -35,7 +37,8 @@ struct ConditionFunction {
   /** @brief a name for the condition */
   std::string name;
   /** @brief the actual callable function */
-  std::function<Condition(const std::vector<std::string> &)> function;
+  std::function<Condition(const Catalog &, const std::vector<std::string> &)>
+      function;
 };
 
 /**
@@ -48,24 +51,107 @@ struct Operation {
   std::function<Condition(const std::vector<Condition> &)> function;
   /** @brief the number of conditions the operation is applied to */
   size_t arity;
+  /** @brief whether the order of the conditions doesn't matter */
+  bool commutative;
+};
+
+/**
+ * @brief Expression is a selected filter as a tree of conditions and
+ * operations, so it can be kept, printed and compiled again later.
+ */
+struct Expression {
+  /** @brief the name of a condition or operation, or "All" */
+  std::string name;
+  /** @brief the arguments of a condition */
+  std::vector<std::string> arguments;
+  /** @brief the expressions an operation is applied to */
+  std::vector<Expression> children;
 };
 
+/**
+ * @brief An interactive menu to choose a filter, including combining as many
+ * conditions as you want. Prints the conditions selected in the order,
+ * left-to-right, that they are evaluated.
+ * @param &catalog The catalog, whose data some arguments are chosen from
+ * @return the selected filter
+ * @see GetCondition
+ * @see GetOperation
+ */
+Expression GetFilter(const Catalog &catalog);
+
+/**
+ * @param &catalog The catalog whose heroes the filter is for
+ * @param &expression A filter
+ * @return the Condition that the filter describes
+ * @throw std::invalid_argument if the filter has an unknown condition or
+ * operation, or invalid arguments
+ */
+Condition Compile(const Catalog &catalog, const Expression &expression);
+
+/**
+ * @brief Wraps the Condition of each node of a filter, e.g. to count how often
+ * it's evaluated. The nodes an operation is applied to are wrapped before the
+ * operation.
+ */
+using Wrapper = std::function<Condition(const Expression &, Condition)>;
+
+/**
+ * @brief Compile, with the Condition of each node wrapped.
+ * @param &wrapper Called for each node, unless it's empty
+ * @see Compile
+ */
+Condition Compile(const Catalog &catalog, const Expression &expression,
+                  const Wrapper &wrapper);
+
+/**
+ * @param &expression A filter
+ * @return the filter as text, e.g. And(Owned(), Good(1))
+ */
+std::string ToString(const Expression &expression);
+
+/**
+ * @brief Reads a filter from text, the opposite of ToString. Spaces between
+ * the parts are ignored, and arguments with commas, brackets or quotes can be
+ * quoted like CSV fields.
+ * @param &text A filter as text, e.g. And(Owned(), Good(1, 2))
+ * @return the filter. Its conditions and arguments aren't checked; Compile
+ * does that.
+ * @throw std::invalid_argument if the text isn't a filter, e.g. the brackets
+ * don't match
+ */
+Expression Parse(const std::string &text);
+
+/**
+ * @brief Makes a filter canonical, so that filters that always have the same
+ * result are equal: the conditions of commutative operations are sorted,
+ * spaces around arguments are removed, numbers are written plainly (except
+ * in texts searched for), and the tiers of Good and GoodAsOf and the texts of
+ * HeroContains and MethodContains are sorted without duplicates.
+ * @param &expression A filter
+ * @return the canonical filter
+ */
+Expression Normalize(const Expression &expression);
+
 /**
  * @brief An interactive menu to choose one condition to filter.
+ * @param &catalog The catalog
  * @param &filters Reference to a queue of conditions to keep track of them.
- * @return the condition (which is also added to the queue)
+ * @return the condition (whose name is also added to the queue)
  * @see GetArguments
  */
-Condition GetCondition(std::queue<std::string> &filters);
+Expression GetCondition(const Catalog &catalog,
+                        std::queue<std::string> &filters);
 
 /**
  * @brief The function that handles deciding which conditions need which
  * arguments, and then calls AskForArguments.
+ * @param &catalog The catalog, e.g. for its acquisition methods
  * @param int_input The user's selection of condition
  * @return the arguments (a vector of strings, possibly empty).
  * @see AskForArguments
  */
-std::vector<std::string> GetArguments(size_t int_input);
+std::vector<std::string> GetArguments(const Catalog &catalog,
+                                      size_t int_input);
 
 /**
  * @brief An interactive menu to choose the arguments for conditions that need
@@ -84,6 +170,7 @@ std::vector<std::string> AskForArguments(std::string name,
  * @brief An interactive menu to choose an operation (if any) to apply to the
  * condition. Then calls HandleOperation to apply it, including asking for
  * another condition if needed.
+ * @param &catalog The catalog
  * @param &condition Reference to the initial condition.
  * @param &sentinel_finished Track whether user is finished applying operations
  * (i.e. set to true when they choose to get results).
@@ -91,12 +178,14 @@ std::vector<std::string> AskForArguments(std::string name,
  * @return the resulting condition (e.g. A AND B).
  * @see HandleOperation
  */
-Condition GetOperation(Condition &condition, bool &sentinel_finished,
-                       std::queue<std::string> &filters);
+Expression GetOperation(const Catalog &catalog, Expression &condition,
+                        bool &sentinel_finished,
+                        std::queue<std::string> &filters);
 
 /**
  * @brief The function that takes the operation to be applied, and handles it.
  * Calls GetCondition to ask for another condition if needed.
+ * @param &catalog The catalog
  * @param &condition Reference to the initial condition.
  * @param operation The selected operation to apply to condition.
  * @param &filters Reference to a queue of conditions to keep track of them.
@@ -105,12 +194,14 @@ Condition GetOperation(Condition &condition, bool &sentinel_finished,
  * @see GetCondition
  * @throw std::invalid_argument if operation has non-positive 'arity'
  */
-Condition HandleOperation(Condition &condition, Operation operation,
-                          std::queue<std::string> &filters);
+Expression HandleOperation(const Catalog &catalog, Expression &condition,
+                           Operation operation,
+                           std::queue<std::string> &filters);
 
 /**
  * @name Conditions
- * @brief All conditions take a list of arguments, and return a Condition.
+ * @brief All conditions take the catalog and a list of arguments, and return
+ * a Condition.
  * The first few conditions are straightforwardly the hero data fields.
  * All the conditions are hardcoded in the list conditions. The list needs
  * to stay updated - it's what the program uses.
@@ -122,78 +213,120 @@ Condition HandleOperation(Condition &condition, Operation operation,
  * @return Condition that is true if Hero is that attribute.
  * @throw std::invalid_argument
  */
-Condition Attribute(const std::vector<std::string> &arguments);
+Condition Attribute(const Catalog &catalog,
+                    const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector contains 1 string, the name of a starting grade.
  * @return Condition that is true if Hero is that starting grade.
  * @throw std::invalid_argument
  */
-Condition StartingGrade(const std::vector<std::string> &arguments);
+Condition StartingGrade(const Catalog &catalog,
+                        const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector contains 1 string, the name of a character.
  * @return Condition that is true if Hero is that character.
  * @throw std::invalid_argument
  */
-Condition Character(const std::vector<std::string> &arguments);
+Condition Character(const Catalog &catalog,
+                    const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector is empty.
  * @return Condition that is true if Hero is upgradable to LR.
  * @throw std::invalid_argument
  */
-Condition LR(const std::vector<std::string> &arguments);
+Condition LR(const Catalog &catalog,
+             const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector contains 1 string, the name of a race.
  * @return Condition that is true if Hero is that race.
  * @throw std::invalid_argument
  */
-Condition Race(const std::vector<std::string> &arguments);
+Condition Race(const Catalog &catalog,
+               const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector contains 1 string, the name of a characteristic.
  * @return Condition that is true if Hero is that characteristic.
  * @throw std::invalid_argument
  */
-Condition Characteristic(const std::vector<std::string> &arguments);
+Condition Characteristic(const Catalog &catalog,
+                         const std::vector<std::string> &arguments);
 
 /**
- * @param &arguments The vector contains between 1 and 5 numbers, any ranks.
+ * @param &arguments The vector contains between 1 and 5 numbers, any ranks
+ * from 1 to Hero::MAX_TIER.
  * @return Condition that is true if Hero is in any of those ranks on any of the
  * tier lists.
  * @throw std::invalid_argument
  */
-Condition Good(const std::vector<std::string> &arguments);
+Condition Good(const Catalog &catalog,
+               const std::vector<std::string> &arguments);
+
+/**
+ * @param &arguments The vector contains the name of a tier list, a revision
+ * number, and between 1 and 5 numbers, any ranks from 1 to Hero::MAX_TIER.
+ * @return Condition that is true if Hero was in any of those ranks on that
+ * tier list as of that revision.
+ * @throw std::invalid_argument
+ * @see TierLists::TierList::AsOf
+ */
+Condition GoodAsOf(const Catalog &catalog,
+                   const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector is empty.
  * @return Condition that is true if Hero is owned.
  * @throw std::invalid_argument
  */
-Condition Owned(const std::vector<std::string> &arguments);
+Condition Owned(const Catalog &catalog,
+                const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector is empty.
  * @return Condition that is true if Hero is currently acquirable.
  * @throw std::invalid_argument
  */
-Condition Acquirable(const std::vector<std::string> &arguments);
+Condition Acquirable(const Catalog &catalog,
+                     const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector contains 1 string, the name of a draw.
  * @return Condition that is true if Hero is available from that draw.
  * @throw std::invalid_argument
  */
-Condition AvailableByMethod(const std::vector<std::string> &arguments);
+Condition AvailableByMethod(const Catalog &catalog,
+                            const std::vector<std::string> &arguments);
 
 /**
  * @param &arguments The vector is empty.
  * @return Condition that is true if Hero is owned and above level 80.
  * @throw std::invalid_argument
  */
-Condition Upgraded(const std::vector<std::string> &arguments);
+Condition Upgraded(const Catalog &catalog,
+                   const std::vector<std::string> &arguments);
+
+/**
+ * @param &arguments The vector contains at least 1 string, e.g. [Advent of.
+ * @return Condition that is true if Hero's name (Hero::hero) contains all of
+ * them, ignoring case. The heroes are found with Catalog::titles.
+ * @throw std::invalid_argument
+ */
+Condition HeroContains(const Catalog &catalog,
+                       const std::vector<std::string> &arguments);
+
+/**
+ * @param &arguments The vector contains at least 1 string, e.g. Anniversary.
+ * @return Condition that is true if Hero is available from a draw or other
+ * acquisition method whose heading contains all of them, ignoring case. The
+ * headings are found with Catalog::headings.
+ * @throw std::invalid_argument
+ */
+Condition MethodContains(const Catalog &catalog,
+                         const std::vector<std::string> &arguments);
 
 /**@}*/
 
@@ -241,9 +374,12 @@ const std::vector<ConditionFunction> conditions = {
     {"Acquirable", Acquirable},
     {"AvailableByMethod", AvailableByMethod},
     {"Upgraded", Upgraded},
+    {"GoodAsOf", GoodAsOf},
+    {"HeroContains", HeroContains},
+    {"MethodContains", MethodContains},
 };
 
 /** @brief Hardcoded list of all operations */
 const std::vector<Operation> operations = {
-    {"And", And, 2}, {"Or", Or, 2}, {"Not", Not, 1}};
+    {"And", And, 2, true}, {"Or", Or, 2, true}, {"Not", Not, 1, false}};
 } // namespace Filter
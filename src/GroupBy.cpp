@@ -0,0 +1,526 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Catalog.h"
+#include "GroupBy.h"
+#include "Hero.h"
+#include "Order.h"
+#include "Stats.h"
+#include "TierLists.h"
+#include "Utilities.h"
+
+namespace GroupBy {
+namespace {
+/** @brief The most possible groups that are numbered without sorting */
+constexpr uint64_t MAX_DENSE_GROUPS{1 << 20};
+
+/** @brief The number of addresses of key values remembered, a power of 2 */
+constexpr size_t ADDRESS_CACHE_SIZE{256};
+
+/** @brief The most distinct values of a key that are compared one at a time,
+ * rather than hashed, to find a value that isn't in the cache */
+constexpr size_t MAX_SCANNED_VALUES{16};
+
+/** @brief A column value that isn't there, e.g. the level of a hero that
+ * isn't owned */
+constexpr int64_t MISSING{-1};
+
+/** @brief The names of the functions, in the order of Function */
+const std::vector<std::string> FUNCTIONS = {"Count", "Owned", "PercentOwned",
+                                            "Min",   "Max",   "Avg"};
+
+/** @brief The Order::columns columns that are only there for owned heroes */
+const std::vector<std::string> OWNED_COLUMNS = {"Grade", "Level", "Stars",
+                                                "Unique", "Ultimate"};
+
+/** @brief Text kept by the keys, which lasts as long as the program */
+const Text TRUE_TEXT{"true", 4};
+const Text FALSE_TEXT{"false", 5};
+const Text NONE_TEXT{"-", 1};
+
+/** @return the key with a name */
+const Key &FindKey(const std::string &name) {
+  for (const Key &key : keys) {
+    if (key.name == name) {
+      return key;
+    }
+  }
+  throw std::invalid_argument("Unknown group-by key " + name);
+}
+
+/** @brief Where a column's values come from: an Order::columns column, or
+ * else a tier list */
+struct Source {
+  const Order::Column *column;
+  size_t tier_list;
+  bool owned_only;
+  /** @brief whether the column is BestTier, which is missing when it's more
+   * than Hero::MAX_TIER */
+  bool best_tier;
+};
+
+/** @return where the values of a column come from */
+Source FindSource(const Catalog &catalog, const std::string &name) {
+  for (const Order::Column &column : Order::columns) {
+    if (column.name == name) {
+      return {&column, 0,
+              std::find(OWNED_COLUMNS.begin(), OWNED_COLUMNS.end(), name) !=
+                  OWNED_COLUMNS.end(),
+              name == "BestTier"};
+    }
+  }
+  try {
+    return {nullptr, TierLists::Find(catalog.tier_lists, name), false, false};
+  } catch (std::invalid_argument &) {
+    throw std::invalid_argument("Unknown column " + name +
+                                "; it should be a sort column or a tier list.");
+  }
+}
+
+/** @return a hero's value of a column, or MISSING */
+int64_t Value(const Catalog &catalog, const Hero &hero, const Source &source) {
+  if (source.column == nullptr) {
+    int tier = catalog.tier_lists[source.tier_list].Latest()[hero.index];
+    return tier == 0 ? MISSING : tier;
+  }
+  if (source.owned_only && !hero.owned) {
+    return MISSING;
+  }
+  uint64_t value = source.column->value(catalog, hero);
+  if (source.best_tier && value > Hero::MAX_TIER) {
+    return MISSING;
+  }
+  return static_cast<int64_t>(value);
+}
+
+/** @return a value of a column as text: grades by name, numbers as they are */
+std::string FormatValue(const std::string &column, int64_t value) {
+  if (column == "StartingGrade" &&
+      static_cast<size_t>(value) < Hero::StartingGrades::VALUES.size()) {
+    return Hero::StartingGrades::VALUES[static_cast<size_t>(value)];
+  }
+  if (column == "Grade" && value > 0 &&
+      static_cast<size_t>(value) <= Hero::Grades::VALUES.size()) {
+    return Hero::Grades::VALUES[static_cast<size_t>(value) - 1];
+  }
+  return std::to_string(value);
+}
+
+/** @return a number with a few decimals */
+std::string FormatDecimal(double value, int decimals) {
+  std::array<char, 32> out{};
+  std::snprintf(out.data(), out.size(), "%.*f", decimals, value);
+  return out.data();
+}
+
+/**
+ * @brief The values of a key for some heroes, numbered: the values of the
+ * hero rows[i] are codes[offsets[i]] to codes[offsets[i + 1]], and the value
+ * numbered n is values[n].
+ */
+struct Coded {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> codes;
+  std::vector<std::string> values;
+  /** @brief the numbers of the values last found at some addresses: most
+   * values are interned, so they're usually found without their text */
+  std::array<std::pair<const char *, uint32_t>, ADDRESS_CACHE_SIZE> cache;
+  std::unordered_map<std::string, uint32_t> by_text;
+};
+
+/** @return the number of a value of a key, numbering it if it's new */
+uint32_t Code(Coded &coded, const Text &value) {
+  std::pair<const char *, uint32_t> &cached =
+      coded.cache[(reinterpret_cast<uintptr_t>(value.data()) >> 3) %
+                  ADDRESS_CACHE_SIZE];
+  if (cached.first == value.data() &&
+      coded.values[cached.second].size() == value.size()) {
+    return cached.second;
+  }
+  // a few values are quicker to compare than to hash
+  uint32_t code = static_cast<uint32_t>(coded.values.size());
+  if (coded.values.size() <= MAX_SCANNED_VALUES) {
+    code = static_cast<uint32_t>(
+        std::find(coded.values.begin(), coded.values.end(), value) -
+        coded.values.begin());
+  } else {
+    auto found = coded.by_text.find(value.str());
+    if (found != coded.by_text.end()) {
+      code = found->second;
+    }
+  }
+  if (code == coded.values.size()) {
+    coded.by_text.emplace(value.str(), code);
+    coded.values.push_back(value.str());
+  }
+  cached = {value.data(), code};
+  return code;
+}
+
+/** @brief Renumbers the values of a key in the key's order */
+void Renumber(Coded &coded, const Key &key) {
+  std::vector<uint32_t> sorted(coded.values.size());
+  for (uint32_t i{0}; i < sorted.size(); i++) {
+    sorted[i] = i;
+  }
+  auto position = [&key](const std::string &value) {
+    return static_cast<size_t>(
+        std::find(key.order.begin(), key.order.end(), value) -
+        key.order.begin());
+  };
+  std::sort(sorted.begin(), sorted.end(),
+            [&coded, &position](uint32_t lhs, uint32_t rhs) {
+              size_t lhs_position = position(coded.values[lhs]);
+              size_t rhs_position = position(coded.values[rhs]);
+              if (lhs_position != rhs_position) {
+                return lhs_position < rhs_position;
+              }
+              return coded.values[lhs] < coded.values[rhs];
+            });
+  std::vector<uint32_t> renumbered(sorted.size());
+  std::vector<std::string> values(sorted.size());
+  for (uint32_t i{0}; i < sorted.size(); i++) {
+    renumbered[sorted[i]] = i;
+    values[i] = coded.values[sorted[i]];
+  }
+  for (uint32_t &code : coded.codes) {
+    code = renumbered[code];
+  }
+  coded.values.swap(values);
+}
+
+/** @brief The sums of a column for each group */
+struct Accumulator {
+  std::vector<uint64_t> count;
+  std::vector<int64_t> sum;
+  std::vector<int64_t> min;
+  std::vector<int64_t> max;
+};
+} // namespace
+
+std::vector<std::string> ParseKeys(const std::string &text) {
+  std::vector<std::string> names{};
+  for (const std::string &part : Utilities::ParseCSV(text)) {
+    std::string name = Utilities::Trim(part);
+    if (!name.empty()) {
+      FindKey(name);
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+std::vector<Aggregate> ParseAggregates(const Catalog &catalog,
+                                       const std::string &text) {
+  std::vector<Aggregate> aggregates{};
+  for (const std::string &part : Utilities::ParseCSV(text)) {
+    std::string item = Utilities::Trim(part);
+    std::string function = item;
+    std::string column{};
+    size_t open = item.find('(');
+    if (open != std::string::npos) {
+      if (item.back() != ')') {
+        throw std::invalid_argument("Missing ) in aggregate " + item);
+      }
+      function = Utilities::Trim(item.substr(0, open));
+      column = Utilities::Trim(item.substr(open + 1, item.size() - open - 2));
+    }
+    auto found = std::find(FUNCTIONS.begin(), FUNCTIONS.end(), function);
+    if (found == FUNCTIONS.end()) {
+      throw std::invalid_argument("Unknown aggregate " + item);
+    }
+    Aggregate aggregate{
+        static_cast<Function>(found - FUNCTIONS.begin()), column};
+    bool has_column = aggregate.function == Function::MIN ||
+                      aggregate.function == Function::MAX ||
+                      aggregate.function == Function::AVG;
+    if (has_column && column.empty()) {
+      throw std::invalid_argument("The aggregate " + function +
+                                  " needs a column, e.g. " + function +
+                                  "(Level).");
+    }
+    if (!has_column && !column.empty()) {
+      throw std::invalid_argument("The aggregate " + function +
+                                  " doesn't take a column.");
+    }
+    if (has_column) {
+      FindSource(catalog, column);
+    }
+    aggregates.push_back(aggregate);
+  }
+  if (aggregates.empty()) {
+    throw std::invalid_argument("There are no aggregates.");
+  }
+  return aggregates;
+}
+
+std::string ToString(const Aggregate &aggregate) {
+  std::string out = FUNCTIONS[static_cast<size_t>(aggregate.function)];
+  if (!aggregate.column.empty()) {
+    out += "(" + aggregate.column + ")";
+  }
+  return out;
+}
+
+Table Run(const Catalog &catalog, const std::vector<size_t> &rows,
+          const std::vector<std::string> &names,
+          const std::vector<Aggregate> &aggregates) {
+  STATS_TIMER("GroupBy/Run");
+  Table table{};
+  std::vector<const Key *> used{};
+  for (const std::string &name : names) {
+    used.push_back(&FindKey(name));
+    table.headings.push_back(name);
+  }
+  // each column is read once however many aggregates use it
+  std::vector<std::string> columns{};
+  std::vector<size_t> aggregate_columns{};
+  for (const Aggregate &aggregate : aggregates) {
+    table.headings.push_back(ToString(aggregate));
+    size_t column = static_cast<size_t>(
+        std::find(columns.begin(), columns.end(), aggregate.column) -
+        columns.begin());
+    if (column == columns.size() && !aggregate.column.empty()) {
+      columns.push_back(aggregate.column);
+    }
+    aggregate_columns.push_back(column);
+  }
+  std::vector<Source> sources{};
+  for (const std::string &column : columns) {
+    sources.push_back(FindSource(catalog, column));
+  }
+
+  // read each hero once, as heroes are large, into columns: whether it's
+  // owned, the numbers of its values of each key and its value of each
+  // aggregated column
+  std::vector<Coded> coded(used.size());
+  for (Coded &key : coded) {
+    key.offsets.reserve(rows.size() + 1);
+    key.offsets.push_back(0);
+    key.codes.reserve(rows.size());
+  }
+  std::vector<uint8_t> owned_rows(rows.size());
+  std::vector<std::vector<int64_t>> values(
+      sources.size(), std::vector<int64_t>(rows.size()));
+  Text single{};
+  for (size_t i{0}; i < rows.size(); i++) {
+    const Hero &hero = catalog.list[rows[i]];
+    owned_rows[i] = hero.owned;
+    for (size_t k{0}; k < used.size(); k++) {
+      for (const Text &value : used[k]->values(hero, single)) {
+        coded[k].codes.push_back(Code(coded[k], value));
+      }
+      coded[k].offsets.push_back(static_cast<uint32_t>(coded[k].codes.size()));
+    }
+    for (size_t c{0}; c < sources.size(); c++) {
+      values[c][i] = Value(catalog, hero, sources[c]);
+    }
+  }
+
+  // number each combination of values, the first key the most significant,
+  // so groups in order of their numbers are in order of their keys
+  for (size_t k{0}; k < used.size(); k++) {
+    Renumber(coded[k], *used[k]);
+  }
+  std::vector<uint64_t> strides(used.size(), 1);
+  uint64_t possible{1};
+  for (size_t k = used.size(); k-- > 0;) {
+    strides[k] = possible;
+    uint64_t size = std::max<uint64_t>(coded[k].values.size(), 1);
+    if (possible > std::numeric_limits<uint64_t>::max() / size) {
+      throw std::invalid_argument("There are too many possible groups.");
+    }
+    possible *= size;
+  }
+
+  // a hero is an item in the group of each combination of its values
+  std::vector<uint64_t> item_ids{};
+  std::vector<uint32_t> item_rows{};
+  item_ids.reserve(rows.size());
+  item_rows.reserve(rows.size());
+  std::vector<uint32_t> positions(used.size(), 0);
+  for (uint32_t i{0}; i < rows.size(); i++) {
+    if (std::any_of(coded.begin(), coded.end(), [i](const Coded &key) {
+          return key.offsets[i] == key.offsets[i + 1];
+        })) {
+      continue;
+    }
+    while (true) {
+      uint64_t id{0};
+      for (size_t k{0}; k < used.size(); k++) {
+        id += coded[k].codes[coded[k].offsets[i] + positions[k]] * strides[k];
+      }
+      item_ids.push_back(id);
+      item_rows.push_back(i);
+      // the next combination, counting with the last key fastest; positions
+      // are all 0 again after the last one
+      size_t k = used.size();
+      while (k > 0 && ++positions[k - 1] == coded[k - 1].offsets[i + 1] -
+                                                coded[k - 1].offsets[i]) {
+        positions[k - 1] = 0;
+        k--;
+      }
+      if (k == 0) {
+        break;
+      }
+    }
+  }
+
+  // number the groups that have items in order
+  std::vector<uint64_t> group_ids{};
+  std::vector<uint32_t> item_groups(item_ids.size());
+  if (possible <= MAX_DENSE_GROUPS) {
+    std::vector<uint32_t> groups(possible, 0);
+    for (uint64_t id : item_ids) {
+      groups[id] = 1;
+    }
+    for (uint64_t id{0}; id < possible; id++) {
+      if (groups[id] != 0) {
+        groups[id] = static_cast<uint32_t>(group_ids.size());
+        group_ids.push_back(id);
+      }
+    }
+    for (size_t i{0}; i < item_ids.size(); i++) {
+      item_groups[i] = groups[item_ids[i]];
+    }
+  } else {
+    group_ids = item_ids;
+    std::sort(group_ids.begin(), group_ids.end());
+    group_ids.erase(std::unique(group_ids.begin(), group_ids.end()),
+                    group_ids.end());
+    for (size_t i{0}; i < item_ids.size(); i++) {
+      item_groups[i] = static_cast<uint32_t>(
+          std::lower_bound(group_ids.begin(), group_ids.end(), item_ids[i]) -
+          group_ids.begin());
+    }
+  }
+
+  // count the heroes and owned heroes of each group, then add up each column
+  const size_t size = group_ids.size();
+  std::vector<uint64_t> counts(size, 0);
+  std::vector<uint64_t> owned(size, 0);
+  for (size_t i{0}; i < item_groups.size(); i++) {
+    counts[item_groups[i]]++;
+    owned[item_groups[i]] += owned_rows[item_rows[i]];
+  }
+  std::vector<Accumulator> accumulators{};
+  for (const std::vector<int64_t> &column : values) {
+    Accumulator accumulator{std::vector<uint64_t>(size, 0),
+                            std::vector<int64_t>(size, 0),
+                            std::vector<int64_t>(
+                                size, std::numeric_limits<int64_t>::max()),
+                            std::vector<int64_t>(size, MISSING)};
+    for (size_t i{0}; i < item_groups.size(); i++) {
+      int64_t value = column[item_rows[i]];
+      if (value != MISSING) {
+        uint32_t group = item_groups[i];
+        accumulator.count[group]++;
+        accumulator.sum[group] += value;
+        accumulator.min[group] = std::min(accumulator.min[group], value);
+        accumulator.max[group] = std::max(accumulator.max[group], value);
+      }
+    }
+    accumulators.push_back(std::move(accumulator));
+  }
+
+  for (size_t group{0}; group < size; group++) {
+    std::vector<std::string> row{};
+    for (size_t k{0}; k < used.size(); k++) {
+      uint64_t code = group_ids[group] / strides[k] %
+                      std::max<uint64_t>(coded[k].values.size(), 1);
+      row.push_back(coded[k].values[code]);
+    }
+    for (size_t j{0}; j < aggregates.size(); j++) {
+      switch (aggregates[j].function) {
+      case Function::COUNT:
+        row.push_back(std::to_string(counts[group]));
+        continue;
+      case Function::OWNED:
+        row.push_back(std::to_string(owned[group]));
+        continue;
+      case Function::PERCENT_OWNED:
+        row.push_back(FormatDecimal(
+            100.0 * static_cast<double>(owned[group]) /
+                static_cast<double>(counts[group]),
+            1));
+        continue;
+      default:
+        break;
+      }
+      const Accumulator &accumulator = accumulators[aggregate_columns[j]];
+      if (accumulator.count[group] == 0) {
+        row.push_back("");
+      } else if (aggregates[j].function == Function::MIN) {
+        row.push_back(
+            FormatValue(aggregates[j].column, accumulator.min[group]));
+      } else if (aggregates[j].function == Function::MAX) {
+        row.push_back(
+            FormatValue(aggregates[j].column, accumulator.max[group]));
+      } else {
+        row.push_back(FormatDecimal(
+            static_cast<double>(accumulator.sum[group]) /
+                static_cast<double>(accumulator.count[group]),
+            2));
+      }
+    }
+    table.rows.push_back(std::move(row));
+  }
+  return table;
+}
+
+Span<Text> Attribute(const Hero &hero, Text &value) {
+  value = hero.attribute;
+  return {&value, 1};
+}
+
+Span<Text> StartingGrade(const Hero &hero, Text &value) {
+  value = hero.starting_grade;
+  return {&value, 1};
+}
+
+Span<Text> Character(const Hero &hero, Text &value) {
+  value = hero.character;
+  return {&value, 1};
+}
+
+Span<Text> Characteristic(const Hero &hero, Text &value) {
+  value = hero.characteristic;
+  return {&value, 1};
+}
+
+Span<Text> Race(const Hero &hero, Text &value) {
+  if (hero.races.empty()) {
+    value = NONE_TEXT;
+    return {&value, 1};
+  }
+  return hero.races;
+}
+
+Span<Text> LR(const Hero &hero, Text &value) {
+  value = hero.lr ? TRUE_TEXT : FALSE_TEXT;
+  return {&value, 1};
+}
+
+Span<Text> Owned(const Hero &hero, Text &value) {
+  value = hero.owned ? TRUE_TEXT : FALSE_TEXT;
+  return {&value, 1};
+}
+
+Span<Text> Grade(const Hero &hero, Text &value) {
+  if (!hero.owned) {
+    value = NONE_TEXT;
+  } else {
+    const std::string &grade = hero.upgrades[Hero::GRADE];
+    value = Text{grade.data(), grade.size()};
+  }
+  return {&value, 1};
+}
+} // namespace GroupBy
@@ -0,0 +1,139 @@
+/**
+ * @file GroupBy.h
+ * @brief GroupBy namespace summarizes heroes in a table, e.g. the number of
+ * heroes of each attribute and starting grade, or the average ultimate level
+ * of each race.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+#include "Hero.h"
+
+struct Catalog;
+
+/**
+ * @brief GroupBy namespace groups heroes by the values of some keys, and
+ * aggregates columns of each group, like GROUP BY in SQL. The whole table is
+ * made in one pass a column at a time: each key's values are numbered, the
+ * numbers of the keys make each hero's group, and then each aggregated column
+ * is read once and added to the groups. A hero with several values of a key,
+ * e.g. several races, is in a group for each of them.
+ */
+namespace GroupBy {
+
+/** @brief Key lets me easily name and use group-by keys at runtime. */
+struct Key {
+  /** @brief a name for the key */
+  std::string name;
+  /** @brief its values for a hero. A single value can be kept in value. */
+  std::function<Span<Text>(const Hero &, Text &value)> values;
+  /** @brief values that come first, in this order; other values come after
+   * them, sorted */
+  std::vector<std::string> order;
+};
+
+/** @brief The ways a column can be aggregated */
+enum class Function { COUNT, OWNED, PERCENT_OWNED, MIN, MAX, AVG };
+
+/** @brief A column of the table: a function of a column of the heroes, e.g.
+ * Avg(Ultimate) */
+struct Aggregate {
+  Function function;
+  /** @brief an Order::columns column or a tier list, for MIN, MAX and AVG */
+  std::string column;
+};
+
+/** @brief A table: the keys, then the aggregates, of each group */
+struct Table {
+  std::vector<std::string> headings;
+  std::vector<std::vector<std::string>> rows;
+};
+
+/**
+ * @brief Reads the keys to group by from text, e.g. Attribute, StartingGrade
+ * @param &text The keys
+ * @return their names
+ * @throw std::invalid_argument if a key doesn't exist
+ */
+std::vector<std::string> ParseKeys(const std::string &text);
+
+/**
+ * @brief Reads aggregates from text, e.g. Count, Owned, Avg(Ultimate). The
+ * functions are Count, Owned (the number of owned heroes), PercentOwned, and
+ * Min, Max and Avg of an Order::columns column or a tier list. The owned
+ * columns, e.g. Level, only count owned heroes, and the tiers only count
+ * ranked heroes.
+ * @param &catalog The catalog, for its tier lists
+ * @param &text The aggregates
+ * @return the aggregates
+ * @throw std::invalid_argument if an aggregate or its column doesn't exist
+ */
+std::vector<Aggregate> ParseAggregates(const Catalog &catalog,
+                                       const std::string &text);
+
+/**
+ * @param &aggregate An aggregate
+ * @return the aggregate as text, the opposite of ParseAggregates
+ */
+std::string ToString(const Aggregate &aggregate);
+
+/**
+ * @brief Groups heroes and aggregates each group. Groups are in the order of
+ * their keys, and only groups with heroes are in the table.
+ * @param &catalog The catalog the heroes are in
+ * @param &rows The indices of the heroes in Catalog::list, e.g. the heroes a
+ * filter finds
+ * @param &names The keys to group by; with none, every hero is in one group
+ * @param &aggregates The aggregates
+ * @return the table
+ * @throw std::invalid_argument if a key or column doesn't exist, or there
+ * are too many possible groups
+ */
+Table Run(const Catalog &catalog, const std::vector<size_t> &rows,
+          const std::vector<std::string> &names,
+          const std::vector<Aggregate> &aggregates);
+
+/**
+ * @name Keys
+ * @brief All keys take a hero and somewhere to keep a single value, and
+ * return the hero's values. All the keys are hardcoded in the list keys.
+ * @{
+ */
+
+Span<Text> Attribute(const Hero &hero, Text &value);
+Span<Text> StartingGrade(const Hero &hero, Text &value);
+Span<Text> Character(const Hero &hero, Text &value);
+Span<Text> Characteristic(const Hero &hero, Text &value);
+
+/** @return each of the hero's races, or - if it has none */
+Span<Text> Race(const Hero &hero, Text &value);
+
+/** @return true or false */
+Span<Text> LR(const Hero &hero, Text &value);
+Span<Text> Owned(const Hero &hero, Text &value);
+
+/** @return the owned grade, or - if the hero isn't owned */
+Span<Text> Grade(const Hero &hero, Text &value);
+
+/**@}*/
+
+/** @brief Hardcoded list of all keys */
+const std::vector<Key> keys = {
+    {"Attribute", Attribute, {}},
+    {"StartingGrade", StartingGrade,
+     {Hero::StartingGrades::VALUES.begin(),
+      Hero::StartingGrades::VALUES.end()}},
+    {"Character", Character, {}},
+    {"Characteristic", Characteristic, {}},
+    {"Race", Race, {}},
+    {"LR", LR, {}},
+    {"Owned", Owned, {}},
+    {"Grade", Grade,
+     {Hero::Grades::VALUES.begin(), Hero::Grades::VALUES.end()}}};
+} // namespace GroupBy
@@ -1,84 +1,55 @@
 #include <array>
-#include <deque>
 #include <iostream>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "Catalog.h"
 #include "Hero.h"
-#include "Heroes.h"
+#include "Render.h"
 #include "Utilities.h"
 
-using Utilities::operator<<;
+constexpr std::array<const char *, 4> Hero::StartingGrades::VALUES;
+constexpr int Hero::MAX_TIER;
+constexpr std::array<const char *, 5> Hero::Grades::VALUES;
 
-constexpr std::array<size_t, 4> Hero::NUMERICAL_INFORMATION;
-constexpr std::array<size_t, 1> Hero::BOOLEAN_INFORMATION;
-constexpr std::array<size_t, 3> Hero::NUMERICAL_UPGRADES;
-constexpr std::array<size_t, 1> Hero::BOOLEAN_UPGRADES;
+static_assert(Hero::InformationSchema::SIZE == Hero::INFORMATION_COUNT,
+              "heroes.csv schema has the wrong number of columns");
+static_assert(Hero::UpgradesSchema::SIZE == Hero::UPGRADES_COUNT + 1,
+              "owned.csv schema has the wrong number of columns");
 
 Hero::Hero(const std::array<std::string, INFORMATION_COUNT> &data,
-           std::deque<std::pair<std::string,
-                                std::array<std::string, Hero::UPGRADES_COUNT>>>
-               &upgrades,
-           const std::unordered_map<std::string, std::vector<std::string>>
-               &acquisition)
-    : hero{data[0]}, name{data[1]}, attribute{data[2]}, starting_grade{data[3]},
-      character{data[4]}, lr{data[5] == "true"},    // NOLINT
-      races{Utilities::ParseCSV(data[6])},          // NOLINT
-      characteristic{data[7]},                      // NOLINT
-      tiers{std::stoi(data[8]), std::stoi(data[9]), // NOLINT
-            std::stoi(data[10]),                    // NOLINT
-            std::stoi(data[11])},                   // NOLINT
-      owned{false}, upgrades{}, acquisition{} {
-  // heroes are added in the same order, so check if current hero is owned
-  auto &next_owned = upgrades.front();
-  if (next_owned.first == hero) {
-    owned = true;
-    this->upgrades = next_owned.second;
-    upgrades.pop_front();
+           const std::array<std::string, UPGRADES_COUNT> *upgrades,
+           const std::vector<Text> &acquisition, size_t index, Arena &arena)
+    : hero{arena.Intern(data[0])}, name{arena.Intern(data[1])},
+      attribute{arena.Intern(data[2])},                        // NOLINT
+      starting_grade{arena.Intern(data[3])},                   // NOLINT
+      character{arena.Intern(data[4])}, lr{data[5] == "true"}, // NOLINT
+      races{}, characteristic{arena.Intern(data[7])},          // NOLINT
+      index{index}, owned{upgrades != nullptr}, upgrades{}, acquisition{} {
+  if (owned) {
+    this->upgrades = *upgrades;
   }
 
-  // search for hero in acquisition map in all acquisition methods
-  for (const auto &item : acquisition) {
-    for (const auto &hero_name : item.second) {
-      if (hero == hero_name) {
-        this->acquisition.push_back(item.first);
-        break;
-      }
-    }
+  std::vector<Text> race_list{};
+  for (const std::string &race : Utilities::ParseCSV(data[6])) { // NOLINT
+    race_list.push_back(arena.Intern(race));
   }
+  races = arena.Copy(race_list);
 
   // All R and SR characters are available in all draws, except a few exclusive
   // ones
   if ((starting_grade == "R" || starting_grade == "SR") &&
       characteristic != "Collab" && character != "Waillo") {
-    this->acquisition.emplace_back("all draws");
+    std::vector<Text> methods = acquisition;
+    methods.push_back(arena.Intern("all draws"));
+    this->acquisition = arena.Copy(methods);
+  } else {
+    this->acquisition = arena.Copy(acquisition);
   }
-
-  // Every hero gets added to heroes.
-  Heroes::list.at(Heroes::count) = *this;
-  Heroes::count++;
 }
 
-std::ostream &operator<<(std::ostream &os, const Hero &hero) {
-  os << "Hero: " << hero.hero << ". Name: " << hero.name
-     << ". Attribute: " << hero.attribute
-     << ". Starting grade: " << hero.starting_grade
-     << ". Character: " << hero.character << ", race(s) " << hero.races
-     << ", of " << hero.characteristic << ". Tier " << hero.tiers[0]
-     << " on Amazing's PVP tier list and tier " << hero.tiers[1]
-     << " on his PVE tier list. " << "Tier " << hero.tiers[2]
-     << " on Nagato's PVP tier list and tier " << hero.tiers[3]
-     << " on his PVE tier list. ";
-  if (hero.owned) {
-    os << "I already own this hero at ultimate level "
-       << hero.upgrades[Hero::ULTIMATE] << ".";
-  } else {
-    if (hero.acquisition.empty()) {
-      os << "This hero is not currently acquirable.";
-    } else {
-      os << "This hero is acquired by " << hero.acquisition << ".";
-    }
-  }
-  return os;
-}
\ No newline at end of file
+std::ostream &Hero::Print(std::ostream &os, const Catalog &catalog) const {
+  std::string out{};
+  Render::AppendText(out, catalog, *this);
+  return os << out;
+}
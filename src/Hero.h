@@ -6,42 +6,55 @@
 #pragma once
 
 #include <array>
-#include <deque>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "Arena.h"
+#include "Schema.h"
+
+struct Catalog;
+
 /**
  * @brief A hero is an object of this type; it groups information a hero has.
+ * The information from heroes.csv is stored in the arena of the hero's
+ * dataset, so it's only valid as long as the dataset's arena.
  */
 struct Hero {
   /** @brief The number of pieces of information in heroes.csv file */
   static constexpr size_t INFORMATION_COUNT{12};
-  /** @brief The indices that contain numerical data */
-  static constexpr std::array<size_t, 4> NUMERICAL_INFORMATION{8, 9, 10, 11};
-  /** @brief The indices that contain boolean data */
-  static constexpr std::array<size_t, 1> BOOLEAN_INFORMATION{5};
+  /** @brief The starting grades in heroes.csv */
+  struct StartingGrades {
+    static constexpr std::array<const char *, 4> VALUES{
+        {"R", "SR", "SSR", "UR"}};
+  };
+  /** @brief The highest tier on a tier list */
+  static constexpr int MAX_TIER{6};
+  /** @brief A tier; 0 means unranked */
+  using Tier = Schema::IntRange<0, MAX_TIER>;
+  /** @brief The columns of heroes.csv */
+  using InformationSchema =
+      Schema::Row<Schema::Text, Schema::Text, Schema::Text,
+                  Schema::Enum<StartingGrades>, Schema::Text, Schema::Bool,
+                  Schema::Text, Schema::Text, Tier, Tier, Tier, Tier>;
   /** @brief The hero's entire in-game name (e.g. [Boar Hat] Tavern Master
    * Meliodas) */
-  std::string hero;
+  Text hero;
   /** @brief The hero's "name" (e.g. Tavern Master Meliodas) */
-  std::string name;
+  Text name;
   /** @brief The hero's attribute */
-  std::string attribute;
+  Text attribute;
   /** @brief The hero's starting grade */
-  std::string starting_grade;
+  Text starting_grade;
   /** @brief The hero's character name (e.g. Meliodas) */
-  std::string character;
+  Text character;
   /** @brief Whether the hero has an LR grade upgrade */
   bool lr;
   /** @brief The list of the hero's possibly multiple races */
-  std::vector<std::string> races;
+  Span<Text> races;
   /** @brief The hero's characteristic */
-  std::string characteristic;
-  /** @brief The hero's rank on some different tierlists (a number between 1 and
-   * 5) */
-  std::array<int, 4> tiers;
-  // TODO change the tierlists since Nagato quit lol
+  Text characteristic;
+  /** @brief The hero's position in Catalog::list */
+  size_t index;
 
   // Section: Owned information (in owned.csv file)
   /** @brief Whether you own the hero */
@@ -50,41 +63,46 @@ struct Hero {
   static constexpr size_t UPGRADES_COUNT{5};
   /** @brief These are the upgrades in the upgrades list */
   enum Upgradeable { GRADE, LEVEL, STARS, UNIQUE, ULTIMATE };
-  /** @brief The indices of upgrades that contain numerical data */
-  static constexpr std::array<size_t, 3> NUMERICAL_UPGRADES{2, 3, 5};
-  /** @brief The indices of upgrades that contain boolean data */
-  static constexpr std::array<size_t, 1> BOOLEAN_UPGRADES{4};
+  /** @brief The grades in owned.csv */
+  struct Grades {
+    static constexpr std::array<const char *, 5> VALUES{
+        {"R", "SR", "SSR", "UR", "LR"}};
+  };
+  /** @brief The columns of owned.csv: hero, then the upgrades */
+  using UpgradesSchema =
+      Schema::Row<Schema::Text, Schema::Enum<Grades>, Schema::IntRange<1, 100>,
+                  Schema::IntRange<0, 12>, Schema::Bool,
+                  Schema::IntRange<1, 6>>;
   /** @brief A list of the hero's upgrades. */
   std::array<std::string, UPGRADES_COUNT> upgrades;
 
   /** @brief A list of the ways the hero can currently be obtained in-game. */
-  std::vector<std::string> acquisition;
+  Span<Text> acquisition;
 
   /**
-   * @brief Constructs a hero object, and adds it to heroes.
+   * @brief Constructs a hero object.
    * @param data The list from the line in heroes.csv specific to the hero being
    * constructed
-   * @param upgrades The queue { {Hero name, [Upgrades list]}, ... }
-   * @param acquisition The hashmap { Method name => [Hero list], ... }
+   * @param upgrades The hero's [Upgrades list] from owned.csv, or nullptr if
+   * the hero isn't owned
+   * @param acquisition The names of the acquisition methods that have the hero,
+   * interned in arena
+   * @param index The hero's position in the list of heroes
+   * @param &arena The arena the hero's information is stored in
    */
   Hero(const std::array<std::string, INFORMATION_COUNT> &data,
-       std::deque<std::pair<std::string,
-                            std::array<std::string, Hero::UPGRADES_COUNT>>>
-           &upgrades,
-       const std::unordered_map<std::string, std::vector<std::string>>
-           &acquisition);
-
-  /** @brief Default constructor only used to populate empty list */
-  Hero() : lr{}, tiers{}, owned{} {}
+       const std::array<std::string, UPGRADES_COUNT> *upgrades,
+       const std::vector<Text> &acquisition, size_t index, Arena &arena);
 
-  /** @brief Check if hero is default constructed */
-  bool empty() const { return hero.empty(); }
+  /** @brief Default constructor only used to make room in the list */
+  Hero() : lr{}, index{}, owned{} {}
 
   /**
    * @brief Prints a hero's data, excluding upgrades.
    * @param &os The outstream that the message will be printed to
-   * @param &hero The hero
+   * @param &catalog The catalog the hero is in, for the names of its tier
+   * lists
    * @return The outstream that the message has been printed to
    */
-  friend std::ostream &operator<<(std::ostream &os, const Hero &hero);
+  std::ostream &Print(std::ostream &os, const Catalog &catalog) const;
 };
\ No newline at end of file
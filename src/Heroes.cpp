@@ -1,61 +1,296 @@
 #include <algorithm>
-#include <deque>
 #include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "Arena.h"
+#include "Catalog.h"
 #include "Hero.h"
 #include "Heroes.h"
+#include "Journal.h"
+#include "Memory.h"
+#include "Schema.h"
+#include "Stats.h"
+#include "TierLists.h"
 #include "Utilities.h"
 
 namespace Heroes {
 
-std::array<Hero, COUNT> list{};
+namespace {
+/** @brief The most lines of a data file parsed together, in one thread */
+constexpr size_t LINES_PER_RANGE{1024};
 
-/** @brief The number of heroes that have been created and added to the list so
- * far */
-size_t count{};
+/** @brief The columns of tiers.csv: revision, tier list, hero, tier */
+using TiersSchema = Schema::Row<Schema::IntRange<1>, Schema::Text, Schema::Text,
+                                Hero::Tier>;
 
-std::vector<std::string> acquisition_methods{};
+/**
+ * @brief Tokenizes and validates the lines of a CSV data file, in parallel.
+ * Empty lines are skipped.
+ * @param &lines The lines of the file
+ * @param &source_name The name of the file, for the error report
+ * @param parse A function (line, &record, &errors) that makes a record from a
+ * line, and returns whether it's valid or adds the errors
+ * @return the records, in the same order as the file
+ * @throw std::runtime_error listing every invalid line, if there are any
+ */
+template <typename Record, typename Parse>
+std::vector<Record> ParseRecords(const std::vector<std::string> &lines,
+                                 const std::string &source_name, Parse parse) {
+  // each range of lines gets its own lists, so they can be joined in order
+  size_t count = (lines.size() + LINES_PER_RANGE - 1) / LINES_PER_RANGE;
+  std::vector<std::vector<Record>> ranges(count);
+  std::vector<std::vector<std::string>> range_errors(count);
+  auto parse_range = [&lines, &parse, &ranges, &range_errors](size_t range) {
+    size_t end = std::min(lines.size(), (range + 1) * LINES_PER_RANGE);
+    size_t bytes{0};
+    size_t rows{0};
+    std::vector<std::string> errors{};
+    for (size_t i{range * LINES_PER_RANGE}; i < end; i++) {
+      bytes += lines[i].size() + 1;
+      // skip empty lines for grouping
+      if (Utilities::EmptyCSV(lines[i])) {
+        continue;
+      }
+      rows++;
+      Record record{};
+      size_t first_error = errors.size();
+      if (parse(lines[i], record, errors)) {
+        ranges[range].push_back(std::move(record));
+      }
+      for (size_t j{first_error}; j < errors.size(); j++) {
+        range_errors[range].push_back("Line " + std::to_string(i + 1) + ": " +
+                                      errors[j]);
+      }
+    }
+    STATS_COUNT("CSV/bytes parsed", bytes);
+    STATS_COUNT("CSV/rows parsed", rows);
+  };
+  Utilities::ParallelFor(
+      count,
+      [&parse_range](size_t begin, size_t end) {
+        for (size_t range{begin}; range < end; range++) {
+          parse_range(range);
+        }
+      },
+      1);
 
-void MakeHeroes() {
-  if (!list[0].empty()) {
-    throw std::runtime_error("Unexpectedly called MakeHeroes twice.");
+  std::vector<std::string> errors{};
+  for (std::vector<std::string> &range : range_errors) {
+    std::move(range.begin(), range.end(), std::back_inserter(errors));
+  }
+  if (!errors.empty()) {
+    throw std::runtime_error(Schema::Report(source_name, errors));
   }
 
-  // read data files acquisition, draws, owned
-  std::unordered_map<std::string, std::vector<std::string>> acquisition =
-      ReadAcquisitionData();
-  std::deque<
-      std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-      upgrades = ReadOwnedData();
+  std::vector<Record> records{};
+  for (std::vector<Record> &range : ranges) {
+    std::move(range.begin(), range.end(), std::back_inserter(records));
+  }
+  return records;
+}
+} // namespace
 
-  // make copy of owned hero names
-  std::vector<std::string> hero_names(upgrades.size());
-  for (size_t i{0}; i < upgrades.size(); i++) {
-    hero_names[i] = upgrades[i].first;
+void MakeHeroes(Catalog &catalog) {
+  STATS_TIMER("MakeHeroes");
+  MEMORY_PHASE("MakeHeroes");
+  // read data files acquisition, draws, owned, heroes, tiers at the same time;
+  // each reader also tokenizes and validates its records in parallel
+  const std::string &data_dir = catalog.data_dir;
+  catalog.notices.clear();
+  if (!std::ifstream{data_dir + "/owned.csv"}.good()) {
+    catalog.notices.push_back(
+        "Data files found, but no information about your owned heroes "
+        "exists.\nPlease select AddOwned from the menu to add owned heroes.");
+  }
+  Sources sources{};
+  {
+    STATS_TIMER("MakeHeroes/read");
+    MEMORY_PHASE("MakeHeroes/read");
+    auto acquisition = Memory::Async(ReadAcquisitionData, data_dir);
+    auto heroes = Memory::Async(ReadHeroesData, data_dir);
+    auto tiers = Memory::Async(ReadTiersData, data_dir);
+    sources.upgrades = ReadOwnedData(data_dir);
+    sources.acquisition = acquisition.get();
+    sources.heroes = heroes.get();
+    sources.tiers = tiers.get();
+  }
+
+  // construct hero objects and heroes list, and start using them
+  Dataset dataset{};
+  {
+    STATS_TIMER("MakeHeroes/MakeDataset");
+    MEMORY_PHASE("MakeHeroes/MakeDataset");
+    MakeDataset(sources, dataset);
+  }
+  {
+    STATS_TIMER("MakeHeroes/Install");
+    MEMORY_PHASE("MakeHeroes/Install");
+    Install(catalog, dataset);
+  }
+
+  // apply the owned hero updates saved since owned.csv was written
+  STATS_TIMER("MakeHeroes/Journal::Replay");
+  MEMORY_PHASE("MakeHeroes/Journal::Replay");
+  Journal::Replay(catalog);
+}
+
+void MakeDataset(const Sources &sources, Dataset &dataset) {
+  // every hero has its place in the list before any is made, so they can be
+  // made in parallel
+  const size_t count = sources.heroes.size();
+  dataset.list.resize(count);
+  dataset.arena = std::make_shared<Arena>();
+
+  // index the heroes by name; heroes.csv is the source of truth for the names
+  // in the other files, so they're validated while they're looked up here
+  {
+    STATS_TIMER("MakeDataset/index names");
+    MEMORY_PHASE("MakeDataset/index names");
+    dataset.names.reserve(count);
+    for (size_t i{0}; i < count; i++) {
+      if (!dataset.names.emplace(sources.heroes[i][0], i).second) {
+        throw std::runtime_error("Hero name " + // NOLINT
+                                 sources.heroes[i][0] +
+                                 " appears more than once in heroes.csv.");
+      }
+    }
+  }
+  auto find = [&dataset](const std::string &hero_name,
+                         const std::string &source_name) {
+    STATS_COUNT("MakeDataset/name lookups", 1);
+    auto found = dataset.names.find(hero_name);
+    if (found == dataset.names.end()) {
+      throw std::runtime_error("Hero name " + hero_name + " in " + // NOLINT
+                               source_name + " was not found in heroes.csv.");
+    }
+    return found->second;
+  };
+
+  // acquisition sources are acquisition.txt and draws.txt: invert them into
+  // the methods of each hero, in another thread while owned.csv is indexed
+  dataset.acquisition_methods.reserve(sources.acquisition.size());
+  for (const auto &item : sources.acquisition) {
+    dataset.acquisition_methods.push_back(item.first);
+  }
+  auto acquisition = Memory::Async([&sources, &dataset, &find, count]() {
+    STATS_TIMER("MakeDataset/acquisition");
+    MEMORY_PHASE("MakeDataset/acquisition");
+    std::vector<std::vector<Text>> methods(count);
+    dataset.method_heroes.resize(dataset.acquisition_methods.size());
+    for (size_t i{0}; i < dataset.acquisition_methods.size(); i++) {
+      const std::string &method = dataset.acquisition_methods[i];
+      Text text = dataset.arena->Intern(method);
+      std::vector<size_t> &heroes = dataset.method_heroes[i];
+      for (const std::string &hero_name : sources.acquisition.at(method)) {
+        size_t index = find(hero_name, "acquisition.txt or draws.txt");
+        std::vector<Text> &hero_methods = methods[index];
+        if (hero_methods.empty() || hero_methods.back() != text) {
+          hero_methods.push_back(text);
+          heroes.push_back(index);
+        }
+      }
+      std::sort(heroes.begin(), heroes.end());
+    }
+    return methods;
+  });
+
+  // owned sources are owned.csv. Later records replace earlier ones.
+  std::vector<const std::array<std::string, Hero::UPGRADES_COUNT> *> upgrades(
+      count);
+  {
+    STATS_TIMER("MakeDataset/owned");
+    MEMORY_PHASE("MakeDataset/owned");
+    for (const auto &item : sources.upgrades) {
+      upgrades[find(item.first, "owned.csv")] = &item.second;
+    }
+  }
+  std::vector<std::vector<Text>> methods = acquisition.get();
+
+  // construct hero objects and heroes list
+  {
+    STATS_TIMER("MakeDataset/construct heroes");
+    MEMORY_PHASE("MakeDataset/construct heroes");
+    Utilities::ParallelFor(count, [&sources, &dataset, &upgrades,
+                                   &methods](size_t begin, size_t end) {
+      // each range interns into an arena of its own, so the threads only
+      // wait for each other for a new block, and it's merged once at the end
+      Arena arena{*dataset.arena};
+      for (size_t i{begin}; i < end; i++) {
+        dataset.list[i] =
+            Hero{sources.heroes[i], upgrades[i], methods[i], i, arena};
+      }
+      dataset.arena->Merge(arena);
+    });
+  }
+
+  // record the heroes.csv tier lists as revision 0, then add later revisions
+  {
+    STATS_TIMER("MakeDataset/tier lists");
+    MEMORY_PHASE("MakeDataset/tier lists");
+    TierLists::Seed(dataset, sources.heroes);
+    AddTiersData(sources.tiers, dataset);
   }
 
-  // read heroes data file, construct hero objects and heroes list
-  ReadHeroesData(acquisition, upgrades);
+  {
+    STATS_TIMER("MakeDataset/search index");
+    MEMORY_PHASE("MakeDataset/search index");
+    dataset.search.Build(dataset.list);
+  }
 
-  // owned sources are owned.csv
-  ValidateHeroNames(hero_names, "owned.csv");
-  // acquisition sources are acquisition.txt and draws.txt
-  for (const auto &item : acquisition) {
-    hero_names = item.second;
-    ValidateHeroNames(hero_names, "acquisition.txt or draws.txt");
+  STATS_TIMER("MakeDataset/trigram indexes");
+  MEMORY_PHASE("MakeDataset/trigram indexes");
+  std::vector<Text> titles{};
+  titles.reserve(dataset.list.size());
+  for (const Hero &hero : dataset.list) {
+    titles.push_back(hero.hero);
+  }
+  dataset.titles.Build(titles);
+  std::vector<Text> headings{};
+  for (const std::string &method : dataset.acquisition_methods) {
+    headings.emplace_back(method.data(), method.size());
   }
+  dataset.headings.Build(headings);
+}
+
+void Install(Catalog &catalog, Dataset &dataset) {
+  // keep the owned heroes in use, which may have been updated since owned.csv
+  // was read
+  for (size_t i{0}; i < dataset.list.size(); i++) {
+    auto found = catalog.names.find(dataset.list[i].hero);
+    if (found != catalog.names.end()) {
+      dataset.list[i].owned = catalog.list[found->second].owned;
+      dataset.list[i].upgrades = catalog.list[found->second].upgrades;
+    }
+  }
+
+  std::swap(catalog.list, dataset.list);
+  std::swap(catalog.arena, dataset.arena);
+  std::swap(catalog.acquisition_methods, dataset.acquisition_methods);
+  std::swap(catalog.method_heroes, dataset.method_heroes);
+  std::swap(catalog.names, dataset.names);
+  std::swap(catalog.tier_lists, dataset.tier_lists);
+  std::swap(catalog.search, dataset.search);
+  std::swap(catalog.titles, dataset.titles);
+  std::swap(catalog.headings, dataset.headings);
+  std::swap(catalog.revision, dataset.revision);
+  catalog.version++;
 }
 
 std::unordered_map<std::string, std::vector<std::string>>
-ReadAcquisitionData() {
-  std::string DATA_DIR = "../data";
+ReadAcquisitionData(const std::string &data_dir) {
+  STATS_TIMER("Read/acquisition.txt and draws.txt");
+  auto draws_future =
+      Memory::Async(Utilities::ReadLists, data_dir + "/draws.txt");
   std::unordered_map<std::string, std::vector<std::string>> acquisition =
-      Utilities::ReadLists(DATA_DIR + "/acquisition.txt");
+      Utilities::ReadLists(data_dir + "/acquisition.txt");
   std::unordered_map<std::string, std::vector<std::string>> draws =
-      Utilities::ReadLists(DATA_DIR + "/draws.txt");
+      draws_future.get();
   for (const auto &item : draws) {
     if (acquisition.find(item.first) != acquisition.end()) {
       throw std::runtime_error("The heading names in data/acquisition.txt and "
@@ -63,119 +298,177 @@ ReadAcquisitionData() {
     }
     acquisition[item.first] = item.second;
   }
-  acquisition_methods.reserve(acquisition.size());
-  for (const auto &item : acquisition) {
-    acquisition_methods.push_back(item.first);
-  }
   return acquisition;
 }
 
-std::deque<
+std::vector<
     std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-ReadOwnedData() {
-  // look for owned.csv data file
-  std::string DATA_DIR = "../data";
-  std::ifstream file{DATA_DIR + "/owned.csv"};
-  if (!file.good()) {
-    std::cout << "Data files found, but no information about your owned heroes "
-                 "exists."
-              << std::endl;
-    std::cout << "Please select AddOwned from the menu to add owned heroes."
-              << std::endl;
-  }
-
-  // process owned.csv data file
-  std::deque<
-      std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-      upgrades{};
-  while (file.good()) {
-    // read line. skip empty lines for grouping
-    std::string line{};
-    std::getline(file, line);
-    if (Utilities::EmptyCSV(line)) {
-      continue;
-    }
+ReadOwnedData(const std::string &data_dir) {
+  // process owned.csv data file; there are no owned heroes without it
+  return ReadProfile(data_dir + "/owned.csv");
+}
 
-    // read and validate the data
-    //
-    /* each CSV record is a list like [[Boar Hat] Tavern Master Meliodas, UR,
-     * 80, 6, true, 6].
-     * int Hero::UPGRADES_COUNT = 5 is the number of upgradeable fields.
-     * enum Hero::UPGRADEABLE = grade, level, awakening stars, unique unlocked,
-     * ultimate move level.
-     */
-    std::vector<std::string> data = Utilities::ParseCSV(line);
-    Utilities::ValidateList(data, Hero::UPGRADES_COUNT + 1,
-                            Hero::NUMERICAL_UPGRADES, Hero::BOOLEAN_UPGRADES);
+std::vector<
+    std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
+ReadProfile(const std::string &filename) {
+  STATS_TIMER("Read/owned.csv");
+  return ParseRecords<
+      std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>(
+      Utilities::ReadLines(filename), filename,
+      [](const std::string &line,
+         std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>
+             &record,
+         std::vector<std::string> &errors) {
+        // read and validate the data
+        //
+        /* each CSV record is a list like [[Boar Hat] Tavern Master Meliodas,
+         * UR, 80, 6, true, 6].
+         * int Hero::UPGRADES_COUNT = 5 is the number of upgradeable fields.
+         * enum Hero::UPGRADEABLE = grade, level, awakening stars, unique
+         * unlocked, ultimate move level.
+         */
+        std::vector<std::string> data = Utilities::ParseCSV(line);
+        if (!Hero::UpgradesSchema::Validate(data, errors)) {
+          return false;
+        }
 
-    // make data array containing upgrades information (excluding data[0] which
-    // is hero name)
-    std::array<std::string, Hero::UPGRADES_COUNT> data_array{};
-    std::copy_n(data.begin() + 1, Hero::UPGRADES_COUNT, data_array.begin());
+        // make data array containing upgrades information (excluding data[0]
+        // which is hero name)
+        record.first = data[0];
+        std::copy_n(data.begin() + 1, Hero::UPGRADES_COUNT,
+                    record.second.begin());
+        return true;
+      });
+}
 
-    // add data to upgrades queue
-    upgrades.emplace_back(data[0], data_array);
+void LoadProfile(Catalog &catalog, const std::string &filename) {
+  MEMORY_PHASE("LoadProfile");
+  // validate the whole profile before changing any hero
+  auto upgrades = ReadProfile(filename);
+  std::vector<size_t> indices(upgrades.size());
+  for (size_t i{0}; i < upgrades.size(); i++) {
+    auto found = catalog.names.find(upgrades[i].first);
+    if (found == catalog.names.end()) {
+      throw std::runtime_error("Hero name " + upgrades[i].first + // NOLINT
+                               " in " + filename +
+                               " was not found in heroes.csv.");
+    }
+    indices[i] = found->second;
   }
 
-  return upgrades;
+  // later records replace earlier ones
+  for (Hero &hero : catalog.list) {
+    hero.owned = false;
+    hero.upgrades = {};
+  }
+  for (size_t i{0}; i < upgrades.size(); i++) {
+    catalog.list[indices[i]].owned = true;
+    catalog.list[indices[i]].upgrades = upgrades[i].second;
+  }
+  catalog.version++;
 }
 
-void ReadHeroesData(
-    const std::unordered_map<std::string, std::vector<std::string>>
-        &acquisition,
-    std::deque<
-        std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-        &upgrades) {
-  std::string DATA_DIR = "../data";
-  std::ifstream file{DATA_DIR + "/heroes.csv"};
+std::vector<std::array<std::string, Hero::INFORMATION_COUNT>>
+ReadHeroesData(const std::string &data_dir) {
+  STATS_TIMER("Read/heroes.csv");
+  std::string filename = data_dir + "/heroes.csv";
 
   // process heroes.csv data file
-  while (file.good()) {
-    // read line. skip empty lines for grouping
-    std::string line{};
-    std::getline(file, line);
-    if (Utilities::EmptyCSV(line)) {
-      continue;
-    }
+  return ParseRecords<std::array<std::string, Hero::INFORMATION_COUNT>>(
+      Utilities::ReadLines(filename), filename,
+      [](const std::string &line,
+         std::array<std::string, Hero::INFORMATION_COUNT> &record,
+         std::vector<std::string> &errors) {
+        // read and validate the data
+        /* each CSV record is a list like [[Boar Hat] Tavern Master Meliodas,
+         * Tavern Master Meliodas, Speed, SR, Meliodas, false, Demon, The Seven
+         * Deadly Sins, 5, 5, 5, 5] Hero's member attributes name the elements
+         * of the list i.e.: hero, name, attribute, starting grade, character,
+         * LR, race, characteristic, tiers */
+        std::vector<std::string> data = Utilities::ParseCSV(line);
+        if (!Hero::InformationSchema::Validate(data, errors)) {
+          return false;
+        }
 
-    // read and validate the data
-    /* each CSV record is a list like [[Boar Hat] Tavern Master Meliodas, Tavern
-     * Master Meliodas, Speed, SR, Meliodas, false, Demon, The Seven Deadly
-     * Sins, 5, 5, 5, 5] Hero's member attributes name the elements of the list
-     * i.e.: hero, name, attribute, starting grade, character, LR, race,
-     * characteristic, tiers */
-    std::vector<std::string> data = Utilities::ParseCSV(line);
-    Utilities::ValidateList(data, Hero::INFORMATION_COUNT,
-                            Hero::NUMERICAL_INFORMATION,
-                            Hero::BOOLEAN_INFORMATION);
+        // make data array containing hero information
+        std::copy_n(data.begin(), Hero::INFORMATION_COUNT, record.begin());
+        return true;
+      });
+}
+
+std::vector<std::vector<std::string>>
+ReadTiersData(const std::string &data_dir) {
+  STATS_TIMER("Read/tiers.csv");
+  // tiers.csv is optional; without it there is only revision 0
+  std::string filename = data_dir + "/tiers.csv";
 
-    // make data array containing hero information
-    std::array<std::string, Hero::INFORMATION_COUNT> data_array;
-    std::copy_n(data.begin(), Hero::INFORMATION_COUNT, data_array.begin());
+  // read and validate the data
+  /* each CSV record is a list like [1, Amazing's PVP, [Boar Hat] Tavern
+   * Master Meliodas, 4] i.e.: revision, tier list, hero, tier */
+  std::vector<std::vector<std::string>> tiers =
+      ParseRecords<std::vector<std::string>>(
+          Utilities::ReadLines(filename), filename,
+          [](const std::string &line, std::vector<std::string> &record,
+             std::vector<std::string> &errors) {
+            record = Utilities::ParseCSV(line);
+            return TiersSchema::Validate(record, errors);
+          });
 
-    // call the Hero object constructor.
-    Hero hero{data_array, upgrades, acquisition};
+  // the order of the revisions depends on the records before them
+  size_t revision{0};
+  for (const std::vector<std::string> &data : tiers) {
+    size_t record_revision = static_cast<size_t>(std::stoi(data[0]));
+    if (record_revision < revision) {
+      throw std::runtime_error("Invalid revision " + data[0] +
+                               " in tiers.csv. Revisions must be in order.");
+    }
+    revision = record_revision;
   }
+  return tiers;
 }
 
-void ValidateHeroNames(const std::vector<std::string> &hero_names,
-                       const std::string &source_name) {
-  // Checking each hero name in input list...
-  for (const std::string &hero_name : hero_names) {
-    bool hero_found = false;
-    // Looking in heroes list...
-    for (const Hero &hero : Heroes::list) {
-      if (hero.hero == hero_name) {
-        hero_found = true;
-        break;
+void AddTiersData(const std::vector<std::vector<std::string>> &tiers,
+                  Dataset &dataset) {
+  // the records of a revision are one revision of each list they're for, in
+  // the order the lists first appear
+  size_t revision{0};
+  std::vector<std::pair<std::string, std::vector<TierLists::Change>>> lists{};
+  auto commit = [&revision, &lists, &dataset]() {
+    for (const auto &list : lists) {
+      size_t tier_list = TierLists::TryFind(dataset.tier_lists, list.first);
+      if (tier_list == TierLists::NOT_FOUND) {
+        tier_list = TierLists::Register(dataset, list.first);
       }
+      TierLists::Commit(dataset, tier_list, revision, list.second);
+    }
+    lists.clear();
+  };
+
+  for (const std::vector<std::string> &data : tiers) {
+    auto hero = dataset.names.find(data[2]);
+    if (hero == dataset.names.end()) {
+      throw std::runtime_error("Hero name " + data[2] + // NOLINT
+                               " in tiers.csv was not found in heroes.csv.");
+    }
+
+    size_t record_revision = static_cast<size_t>(std::stoi(data[0]));
+    if (record_revision != revision) {
+      commit();
+      revision = record_revision;
     }
-    if (!hero_found) {
-      std::string error_message = "Hero name " + hero_name + " in " + // NOLINT
-                                  source_name + " was not found in heroes.csv.";
-      throw std::runtime_error(error_message);
+    auto list = std::find_if(
+        lists.begin(), lists.end(),
+        [&data](const std::pair<std::string,
+                                std::vector<TierLists::Change>> &item) {
+          return item.first == data[1];
+        });
+    if (list == lists.end()) {
+      lists.emplace_back(data[1], std::vector<TierLists::Change>{});
+      list = lists.end() - 1;
     }
+    list->second.emplace_back(hero->second, std::stoi(data[3]));
   }
+  commit();
 }
 
-} // namespace Heroes
\ No newline at end of file
+} // namespace Heroes
@@ -7,86 +7,194 @@
 
 #include <array>
 #include <cstdlib>
-#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "Arena.h"
 #include "Hero.h"
+#include "Search.h"
+#include "TierLists.h"
+#include "Trigrams.h"
+
+struct Catalog;
 
 /**
  * @brief Heroes namespace contains the code to create the list of heroes
  */
 namespace Heroes {
 
-/** @brief The number of heroes in the game */
-static constexpr size_t COUNT{309};
-
 /**
- * @brief The master list of all heroes; all heroes in the program should be
- * pointers into this list.
- * @see MakeHeroes
+ * @brief Sources is the data read from each of the data files, before any
+ * heroes are made from it. It's kept so that heroes can be made again when
+ * only some of the files change.
  */
-extern std::array<Hero, COUNT> list;
-
-/** @brief The number of heroes that have been created and added to the list so
- * far */
-extern size_t count;
+struct Sources {
+  /** @brief From acquisition.txt and draws.txt: { Method name => [Hero
+   * list], ... } */
+  std::unordered_map<std::string, std::vector<std::string>> acquisition;
+  /** @brief From owned.csv: [ {Hero name, [Upgrades list]}, ... ] */
+  std::vector<
+      std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
+      upgrades;
+  /** @brief From heroes.csv: [ [Hero information], ... ] */
+  std::vector<std::array<std::string, Hero::INFORMATION_COUNT>> heroes;
+  /** @brief From tiers.csv: [ [Revision, Tier list, Hero name, Tier], ... ] */
+  std::vector<std::vector<std::string>> tiers;
+};
 
-extern std::vector<std::string> acquisition_methods;
+/**
+ * @brief Dataset is everything made from the data files. A catalog uses the
+ * one it installed last; others can be made while it's in use, and then
+ * installed. Copies of a dataset share its arena.
+ * @see MakeDataset
+ * @see Install
+ */
+struct Dataset {
+  /** @see Catalog::list */
+  std::vector<Hero> list;
+  /** @see Catalog::arena */
+  std::shared_ptr<Arena> arena;
+  /** @see Catalog::acquisition_methods */
+  std::vector<std::string> acquisition_methods;
+  /** @see Catalog::method_heroes */
+  std::vector<std::vector<size_t>> method_heroes;
+  /** @see Catalog::names */
+  std::unordered_map<std::string, size_t> names;
+  /** @see Catalog::tier_lists */
+  std::vector<TierLists::TierList> tier_lists;
+  /** @see Catalog::search */
+  Search::Index search;
+  /** @see Catalog::titles */
+  Trigrams::Index titles;
+  /** @see Catalog::headings */
+  Trigrams::Index headings;
+  /** @see Catalog::revision */
+  size_t revision;
+};
 
 /**
- * @brief This function processes all the data files. Calls ReadHeroesData,
- * which actually constructs the heroes. It should be the only way heroes are
- * created and it should be called exactly once.
- * @throw std::runtime_error if the function is called while heroes is not
- * empty.
- * @see heroes
+ * @brief This function processes all the data files in a catalog's data
+ * directory. Calls the functions that read each file (at the same time),
+ * makes the heroes with MakeDataset, and installs them in the catalog. It
+ * should be the only way heroes are created when the program starts. It
+ * doesn't print anything or change the data files: messages for the user
+ * are put in Catalog::notices.
+ * @param &catalog The catalog, which should be empty
+ * @see Install
  * @see ReadAcquisitionData
  * @see ReadOwnedData
  * @see ReadHeroesData
+ * @see ReadTiersData
+ * @see MakeDataset
+ * @see Journal::Replay
+ */
+void MakeHeroes(Catalog &catalog);
+
+/**
+ * @brief Makes all the heroes from the data read from the data files, and
+ * validates that the files agree with each other. The hero names in the other
+ * files are validated while the heroes are indexed by name, and the heroes
+ * are made in parallel. It doesn't change the heroes any catalog is using, so
+ * it can be used while they're in use.
+ * @param &sources The data read from the data files
+ * @param &dataset The dataset to make, which should be empty
+ * @throw std::runtime_error if the data files don't agree, e.g. a hero in
+ * draws.txt isn't in heroes.csv, or heroes.csv has a hero twice
+ * @see Hero
+ */
+void MakeDataset(const Sources &sources, Dataset &dataset);
+
+/**
+ * @brief Makes a catalog use a dataset: list, arena, acquisition_methods and
+ * their heroes, names, the tier lists and the search indexes are swapped with
+ * the dataset's. Owned heroes are kept, if they're still in heroes.csv.
+ * @param &catalog The catalog
+ * @param &dataset The dataset to use. Afterwards it has the data the catalog
+ * was using before.
  */
-void MakeHeroes();
+void Install(Catalog &catalog, Dataset &dataset);
 
 /**
  * @brief Read hero acquisition data from acquisition.txt and draws.txt.
+ * @param &data_dir The directory of the data files
  * @throw std::runtime_error if the heading names contain duplicates
  * @return a hashmap { Method name => [Hero list], ... }
  * @see ReadLists
  */
-std::unordered_map<std::string, std::vector<std::string>> ReadAcquisitionData();
+std::unordered_map<std::string, std::vector<std::string>>
+ReadAcquisitionData(const std::string &data_dir);
 
 /**
  * @brief Read owned hero upgrades data from owned.csv.
- * @return a queue { {Hero name, [Upgrades list]}, ... }
+ * @param &data_dir The directory of the data files
+ * @return a list [ {Hero name, [Upgrades list]}, ... ] in the same order as
+ * the file
+ * @throw std::runtime_error if a record has invalid data
  */
-std::deque<
+std::vector<
     std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-ReadOwnedData();
+ReadOwnedData(const std::string &data_dir);
 
 /**
- * @brief Read data from heroes.csv. Construct all the Hero objects, which get
- * added to the heroes list in the constructor. It should be the only way heroes
- * are created and it should be called exactly once.
- * @param acquisition The hashmap { Method name => [Hero list], ... }
- * @param upgrades The queue { {Hero name, [Upgrades list]}, ... }
- * @see Hero
+ * @brief Read owned hero upgrades data from a file in the format of
+ * owned.csv, e.g. a player's profile.
+ * @param &filename The file
+ * @return a list [ {Hero name, [Upgrades list]}, ... ] in the same order as
+ * the file
+ * @throw std::runtime_error if a record has invalid data
+ */
+std::vector<
+    std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
+ReadProfile(const std::string &filename);
+
+/**
+ * @brief Makes a catalog's owned heroes the ones in a profile, instead of the
+ * ones in its owned.csv. Nothing changes if the profile is invalid. The
+ * profile isn't saved in the data directory.
+ * @param &catalog The catalog
+ * @param &filename A file in the format of owned.csv
+ * @throw std::runtime_error if a record has invalid data or an unrecognised
+ * hero name
+ * @see ReadProfile
+ */
+void LoadProfile(Catalog &catalog, const std::string &filename);
+
+/**
+ * @brief Read and validate data from heroes.csv.
+ * @param &data_dir The directory of the data files
+ * @return a list [ [Hero information], ... ] in the same order as the file
+ * @throw std::runtime_error if a record has invalid data
+ */
+std::vector<std::array<std::string, Hero::INFORMATION_COUNT>>
+ReadHeroesData(const std::string &data_dir);
+
+/**
+ * @brief Read and validate the later revisions of the tier lists from
+ * tiers.csv, if it exists.
+ * @param &data_dir The directory of the data files
+ * @return a list [ [Revision, Tier list, Hero name, Tier], ... ] in the same
+ * order as the file
+ * @throw std::runtime_error if a record has invalid data or the revisions
+ * aren't in order
  */
-void ReadHeroesData(
-    const std::unordered_map<std::string, std::vector<std::string>>
-        &acquisition,
-    std::deque<
-        std::pair<std::string, std::array<std::string, Hero::UPGRADES_COUNT>>>
-        &upgrades);
+std::vector<std::vector<std::string>>
+ReadTiersData(const std::string &data_dir);
 
 /**
- * @brief Validates a list of hero names against the program's list, which comes
- * directly from heroes.csv as the source of truth.
- * @param &hero_names The list of hero names
- * @param &source_name The name of the source (e.g. data file) of the list of
- * names
- * @throw std::runtime_error if the list has an unrecognised hero name.
+ * @brief Adds the tier list revisions read from tiers.csv to a dataset. Tier
+ * lists that don't exist yet are registered. It should be called after the
+ * heroes.csv tier lists are registered. The records of each revision are
+ * one revision of each tier list in them, even if records of different lists
+ * are mixed.
+ * @param &tiers The records from tiers.csv
+ * @param &dataset The dataset
+ * @throw std::runtime_error if a record has an unrecognised hero name
+ * @see TierLists::Seed
  */
-void ValidateHeroNames(const std::vector<std::string> &hero_names,
-                       const std::string &source_name);
-} // namespace Heroes
\ No newline at end of file
+void AddTiersData(const std::vector<std::vector<std::string>> &tiers,
+                  Dataset &dataset);
+
+} // namespace Heroes
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AddOwned.h"
+#include "Catalog.h"
+#include "Hero.h"
+#include "Journal.h"
+#include "Schema.h"
+#include "Utilities.h"
+
+namespace Journal {
+
+namespace {
+/** @return the record for a hero's upgrades, without its checksum */
+std::string MakeRecord(const Hero &hero) {
+  std::vector<std::string> data{hero.upgrades.begin(), hero.upgrades.end()};
+  data.insert(data.begin(), hero.hero);
+  return Utilities::MakeCSV(data);
+}
+
+/** @return the checksum of a record, as 8 hexadecimal digits */
+std::string Checksum(const std::string &record) {
+  std::array<char, 9> out{};
+  std::snprintf(out.data(), out.size(), "%08x", Utilities::Crc32(record));
+  return out.data();
+}
+} // namespace
+
+void Append(Catalog &catalog, const Hero &hero) {
+  std::string record = MakeRecord(hero);
+  std::string line = Checksum(record) + "," + record + "\n";
+
+  std::string filename = catalog.data_dir + "/owned.journal";
+  std::FILE *file = std::fopen(filename.c_str(), "ab");
+  if (file == nullptr) {
+    throw std::runtime_error("Could not open " + filename + " to write.");
+  }
+  bool written = std::fwrite(line.data(), 1, line.size(), file) == line.size();
+  try {
+    Utilities::SyncFile(file);
+  } catch (const std::runtime_error &) {
+    written = false;
+  }
+  std::fclose(file);
+  if (!written) {
+    throw std::runtime_error("Could not write to " + filename + ".");
+  }
+  catalog.journal_records++;
+}
+
+size_t Replay(Catalog &catalog) {
+  std::ifstream file{catalog.data_dir + "/owned.journal"};
+
+  catalog.journal_records = 0;
+  bool torn = false;
+  size_t line_number{0};
+  while (file.good()) {
+    std::string line{};
+    std::getline(file, line);
+    line_number++;
+    if (line.empty()) {
+      continue;
+    }
+
+    // a record that was only partly written has the wrong checksum (or none)
+    size_t comma = line.find(',');
+    if (comma == std::string::npos ||
+        line.substr(0, comma) != Checksum(line.substr(comma + 1))) {
+      torn = true;
+      break;
+    }
+
+    // read and validate the data, like a record in owned.csv
+    std::vector<std::string> data = Utilities::ParseCSV(line.substr(comma + 1));
+    std::vector<std::string> errors{};
+    if (!Hero::UpgradesSchema::Validate(data, errors)) {
+      for (std::string &error : errors) {
+        error = "Line " + std::to_string(line_number) + ": " + error;
+      }
+      throw std::runtime_error(
+          Schema::Report(catalog.data_dir + "/owned.journal", errors));
+    }
+    auto found = catalog.names.find(data[0]);
+    if (found == catalog.names.end()) {
+      throw std::runtime_error("Hero name " + data[0] + // NOLINT
+                               " in owned.journal was not found in "
+                               "heroes.csv.");
+    }
+
+    // later records replace earlier ones
+    Hero &hero = catalog.list[found->second];
+    hero.owned = true;
+    std::copy_n(data.begin() + 1, Hero::UPGRADES_COUNT, hero.upgrades.begin());
+    catalog.journal_records++;
+  }
+
+  catalog.journal_torn = torn;
+  if (torn) {
+    catalog.notices.push_back("The last update of your owned heroes was not "
+                              "saved completely, so it was ignored.");
+  }
+  return catalog.journal_records;
+}
+
+void Compact(Catalog &catalog) {
+  // owned.csv has every update once it's replaced, so the journal can be
+  // emptied. If the program stops in between, the records are replayed again,
+  // which is harmless.
+  AddOwned::UpdateFile(catalog);
+  Clear(catalog);
+}
+
+void Clear(Catalog &catalog) {
+  std::string filename = catalog.data_dir + "/owned.journal";
+  std::FILE *file = std::fopen(filename.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("Could not open " + filename + " to write.");
+  }
+  bool emptied{true};
+  try {
+    Utilities::SyncFile(file);
+  } catch (const std::runtime_error &) {
+    emptied = false;
+  }
+  std::fclose(file);
+  if (!emptied) {
+    throw std::runtime_error("Could not empty " + filename + ".");
+  }
+  catalog.journal_records = 0;
+  catalog.journal_torn = false;
+}
+
+bool Recover(Catalog &catalog) {
+  if (!catalog.journal_torn) {
+    return false;
+  }
+  Compact(catalog);
+  return true;
+}
+
+bool CompactIfNeeded(Catalog &catalog) {
+  if (catalog.journal_records < COMPACT_THRESHOLD) {
+    return false;
+  }
+  Compact(catalog);
+  return true;
+}
+} // namespace Journal
@@ -0,0 +1,81 @@
+/**
+ * @file Journal.h
+ * @brief Journal namespace saves owned hero updates by appending them to
+ * data/owned.journal, instead of writing the whole of data/owned.csv every
+ * time. The journal is replayed on top of owned.csv when the data files are
+ * read, and is compacted into owned.csv when it gets long.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "Hero.h"
+
+struct Catalog;
+
+/**
+ * @brief Journal namespace saves owned hero updates by appending them to
+ * data/owned.journal.
+ */
+namespace Journal {
+
+/** @brief The number of records in the journal that makes Compact run */
+static constexpr size_t COMPACT_THRESHOLD{64};
+
+/**
+ * @brief Saves a hero's upgrades by appending one record to the journal. The
+ * record is on disk when the function returns.
+ * Each record is a line like [checksum],[Boar Hat] Tavern Master Meliodas,UR,
+ * 80,6,true,6 where the checksum is the CRC-32 of the rest of the line, in
+ * hexadecimal.
+ * @param &catalog The catalog the hero is in
+ * @param &hero The hero that was updated
+ * @throw std::runtime_error if the journal can't be written
+ */
+void Append(Catalog &catalog, const Hero &hero);
+
+/**
+ * @brief Applies the records in the journal to the heroes in Catalog::list. It
+ * should be called after the heroes are read from heroes.csv and owned.csv. A
+ * record with the wrong checksum means the program stopped while writing it,
+ * so it and anything after it are ignored, and a notice is added to
+ * Catalog::notices. The files aren't changed; see Recover.
+ * @param &catalog The catalog, whose data_dir has the journal
+ * @return the number of records applied
+ * @throw std::runtime_error if a record has an unrecognised hero name or
+ * invalid data
+ */
+size_t Replay(Catalog &catalog);
+
+/**
+ * @brief Writes every owned hero to owned.csv (safely, see
+ * Utilities::WriteFileAtomically) and then empties the journal.
+ * @param &catalog The catalog
+ * @see AddOwned::UpdateFile
+ */
+void Compact(Catalog &catalog);
+
+/**
+ * @brief Empties the journal, once owned.csv has every update in it.
+ * @param &catalog The catalog
+ * @throw std::runtime_error if the journal can't be emptied
+ */
+void Clear(Catalog &catalog);
+
+/**
+ * @brief Calls Compact if Replay found a partly written record, so the
+ * journal ends with a whole record again.
+ * @param &catalog The catalog
+ * @return whether the journal was compacted
+ * @throw std::runtime_error if the files can't be written
+ */
+bool Recover(Catalog &catalog);
+
+/**
+ * @brief Calls Compact if the journal has at least COMPACT_THRESHOLD records.
+ * @param &catalog The catalog
+ * @return whether the journal was compacted
+ */
+bool CompactIfNeeded(Catalog &catalog);
+} // namespace Journal
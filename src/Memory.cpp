@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+#include "Catalog.h"
+#include "Hero.h"
+#include "Memory.h"
+#include "TierLists.h"
+#include "Views.h"
+
+namespace Memory {
+namespace {
+/** @brief What a phase allocated. Every allocation updates these, so they
+ * can't be in a map that allocates. */
+struct Counters {
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> frees;
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> live;
+  std::atomic<uint64_t> peak;
+};
+
+Counters counters[MAX_PHASES];
+
+/** @brief The phase the thread's allocations count as */
+thread_local size_t current{0};
+
+/** @brief Protects Names */
+std::mutex mutex{};
+
+/** @return the names of the phases, by number. It's never destroyed, since
+ * allocations can be freed while the program ends. */
+std::vector<std::string> &Names() {
+  static std::vector<std::string> *names =
+      new std::vector<std::string>{"other"};
+  return *names;
+}
+
+/** @brief An estimate of the memory used by each node of an unordered_map,
+ * besides its element: the next node and the cached hash */
+constexpr size_t NODE_OVERHEAD{2 * sizeof(void *)};
+
+/** @return an estimate of the memory an unordered_map allocated, not counting
+ * what its elements allocate */
+template <typename Key, typename Value>
+size_t Bytes(const std::unordered_map<Key, Value> &map) {
+  return map.bucket_count() * sizeof(void *) +
+         map.size() * (sizeof(std::pair<const Key, Value>) + NODE_OVERHEAD);
+}
+
+#ifdef SDSGC_TRACK_ALLOCATIONS
+/** @brief Stored before each allocation, so it's freed from the phase it was
+ * allocated in. It's the size of 2 pointers, so the memory after it is
+ * aligned like malloc's. */
+struct Header {
+  size_t size;
+  size_t phase;
+};
+
+/** @return the memory, or nullptr if there isn't enough */
+void *Allocate(size_t size) noexcept {
+  size_t phase = current;
+  Header *header = static_cast<Header *>(std::malloc(sizeof(Header) + size));
+  if (header == nullptr) {
+    return nullptr;
+  }
+  header->size = size;
+  header->phase = phase;
+
+  Counters &counter = counters[phase];
+  counter.allocations.fetch_add(1, std::memory_order_relaxed);
+  counter.bytes.fetch_add(size, std::memory_order_relaxed);
+  uint64_t live =
+      counter.live.fetch_add(size, std::memory_order_relaxed) + size;
+  uint64_t peak = counter.peak.load(std::memory_order_relaxed);
+  while (live > peak && !counter.peak.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+  return header + 1;
+}
+
+/** @brief Frees memory from Allocate */
+void Free(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header *header = static_cast<Header *>(ptr) - 1;
+  Counters &counter = counters[header->phase];
+  counter.frees.fetch_add(1, std::memory_order_relaxed);
+  counter.live.fetch_sub(header->size, std::memory_order_relaxed);
+  std::free(header);
+}
+
+/** @brief Allocates like operator new: calls the new handler until there's
+ * enough memory, or throws std::bad_alloc if there's no handler */
+void *AllocateOrThrow(size_t size) {
+  while (true) {
+    void *ptr = Allocate(size);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+#endif
+} // namespace
+
+double Footprint::BytesPerHero() const {
+  return heroes == 0 ? 0.0
+                     : static_cast<double>(Total()) /
+                           static_cast<double>(heroes);
+}
+
+bool Tracking() {
+#ifdef SDSGC_TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t Register(const std::string &name) {
+  std::lock_guard<std::mutex> lock{mutex};
+  std::vector<std::string> &names = Names();
+  auto found = std::find(names.begin(), names.end(), name);
+  if (found != names.end()) {
+    return static_cast<size_t>(found - names.begin());
+  }
+  if (names.size() == MAX_PHASES) {
+    return 0;
+  }
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+size_t Current() { return current; }
+
+Phase::Phase(size_t phase) : previous{current} { current = phase; }
+
+Phase::~Phase() { current = previous; }
+
+std::vector<Usage> Phases() {
+  std::vector<std::string> names{};
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    names = Names();
+  }
+  std::vector<Usage> out{};
+  for (size_t i{0}; i < names.size(); i++) {
+    const Counters &counter = counters[i];
+    Usage usage{names[i], counter.allocations.load(), counter.frees.load(),
+                counter.bytes.load(), counter.live.load(),
+                counter.peak.load()};
+    if (usage.allocations > 0) {
+      out.push_back(usage);
+    }
+  }
+  return out;
+}
+
+void Reset() {
+  for (Counters &counter : counters) {
+    counter.allocations = 0;
+    counter.frees = 0;
+    counter.bytes = 0;
+    counter.peak = counter.live.load();
+  }
+}
+
+Footprint Measure(const Catalog &catalog) {
+  Footprint out{catalog.list.size(), 0, 0, 0, 0, 0, 0};
+
+  // the owned information is part of each hero, but counts as the profile
+  const size_t owned_size = sizeof(Hero::owned) + sizeof(Hero::upgrades);
+  out.catalog = Bytes(catalog.list) - catalog.list.size() * owned_size +
+                Bytes(catalog.acquisition_methods) +
+                Bytes(catalog.data_dir);
+  out.profile = catalog.list.size() * owned_size;
+  for (const Hero &hero : catalog.list) {
+    for (const std::string &upgrade : hero.upgrades) {
+      out.profile += Bytes(upgrade);
+    }
+  }
+  if (catalog.arena) {
+    out.catalog += std::max(catalog.arena->Bytes(),
+                            catalog.arena->Blocks() * Arena::BLOCK_SIZE);
+  }
+  for (const std::string &method : catalog.acquisition_methods) {
+    out.catalog += Bytes(method);
+  }
+  out.catalog += Bytes(catalog.method_heroes);
+  for (const std::vector<size_t> &heroes : catalog.method_heroes) {
+    out.catalog += Bytes(heroes);
+  }
+
+  out.indexes = Bytes(catalog.names);
+  for (const auto &name : catalog.names) {
+    out.indexes += Bytes(name.first);
+  }
+  out.indexes += catalog.search.Bytes() + catalog.titles.Bytes() +
+                 catalog.headings.Bytes();
+
+  out.tier_lists = Bytes(catalog.tier_lists);
+  for (const TierLists::TierList &list : catalog.tier_lists) {
+    out.tier_lists += list.Bytes();
+  }
+
+  out.cache = catalog.cache.statistics.bytes;
+
+  out.views = Bytes(catalog.views);
+  for (const Views::View &view : catalog.views) {
+    out.views += Bytes(view.name) + (view.rows.capacity() + 7) / 8 +
+                 Bytes(view.changed);
+  }
+  return out;
+}
+
+void Print(std::ostream &os, const Catalog &catalog) {
+  std::ios::fmtflags flags = os.flags();
+  if (Tracking()) {
+    os << std::left << std::setw(32) << "phase" << std::right << std::setw(12)
+       << "allocations" << std::setw(12) << "frees" << std::setw(14)
+       << "bytes" << std::setw(14) << "live" << std::setw(14) << "peak"
+       << std::endl;
+    for (const Usage &usage : Phases()) {
+      os << std::left << std::setw(32) << usage.name << std::right
+         << std::setw(12) << usage.allocations << std::setw(12) << usage.frees
+         << std::setw(14) << usage.bytes << std::setw(14) << usage.live
+         << std::setw(14) << usage.peak << std::endl;
+    }
+  } else {
+    os << "Allocations aren't counted. Build with the CMake option "
+          "TRACK_ALLOCATIONS."
+       << std::endl;
+  }
+
+  Footprint footprint = Measure(catalog);
+  os << std::endl
+     << std::left << std::setw(32) << "subsystem" << std::right
+     << std::setw(14) << "bytes" << std::endl;
+  auto line = [&os](const char *name, size_t bytes) {
+    os << std::left << std::setw(32) << name << std::right << std::setw(14)
+       << bytes << std::endl;
+  };
+  line("catalog", footprint.catalog);
+  line("indexes", footprint.indexes);
+  line("tier lists", footprint.tier_lists);
+  line("profile", footprint.profile);
+  line("cache", footprint.cache);
+  line("views", footprint.views);
+  line("total", footprint.Total());
+  os << std::fixed << std::setprecision(1) << "Bytes per hero: "
+     << footprint.BytesPerHero() << ". Bytes per account (profile): "
+     << footprint.profile << "." << std::endl;
+  os.flags(flags);
+}
+
+std::string ToJSON(const Catalog &catalog) {
+  std::string out = std::string{"{\"tracking\": "} +
+                    (Tracking() ? "true" : "false") + ", \"phases\": [";
+  std::vector<Usage> phases = Phases();
+  for (size_t i{0}; i < phases.size(); i++) {
+    const Usage &usage = phases[i];
+    // phase names are chosen in the code, and have no quotes or backslashes
+    out += std::string{i == 0 ? "" : ", "} + "{\"name\": \"" + usage.name +
+           "\", \"allocations\": " + std::to_string(usage.allocations) +
+           ", \"frees\": " + std::to_string(usage.frees) +
+           ", \"bytes\": " + std::to_string(usage.bytes) +
+           ", \"live\": " + std::to_string(usage.live) +
+           ", \"peak\": " + std::to_string(usage.peak) + "}";
+  }
+  Footprint footprint = Measure(catalog);
+  return out + "], \"footprint\": {\"heroes\": " +
+         std::to_string(footprint.heroes) +
+         ", \"catalog\": " + std::to_string(footprint.catalog) +
+         ", \"indexes\": " + std::to_string(footprint.indexes) +
+         ", \"tier_lists\": " + std::to_string(footprint.tier_lists) +
+         ", \"profile\": " + std::to_string(footprint.profile) +
+         ", \"cache\": " + std::to_string(footprint.cache) +
+         ", \"views\": " + std::to_string(footprint.views) +
+         ", \"total\": " + std::to_string(footprint.Total()) +
+         ", \"bytes_per_hero\": " + std::to_string(footprint.BytesPerHero()) +
+         "}}";
+}
+} // namespace Memory
+
+#ifdef SDSGC_TRACK_ALLOCATIONS
+// the replaceable global allocation functions; the rest, e.g. sized delete,
+// call these
+void *operator new(std::size_t size) {
+  return Memory::AllocateOrThrow(size);
+}
+void *operator new[](std::size_t size) {
+  return Memory::AllocateOrThrow(size);
+}
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return Memory::Allocate(size);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return Memory::Allocate(size);
+}
+void operator delete(void *ptr) noexcept { Memory::Free(ptr); }
+void operator delete[](void *ptr) noexcept { Memory::Free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  Memory::Free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  Memory::Free(ptr);
+}
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file Memory.h
+ * @brief Memory namespace measures the memory a catalog uses, and, if the
+ * program is built to track allocations, what each phase of the program
+ * allocates.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct Catalog;
+
+/**
+ * @brief Memory namespace measures the memory a catalog uses by subsystem,
+ * and counts allocations by phase. Counting allocations replaces the global
+ * operator new and delete, so it's only compiled in with
+ * SDSGC_TRACK_ALLOCATIONS defined (the CMake option TRACK_ALLOCATIONS);
+ * otherwise MEMORY_PHASE does nothing and there are no phases. Measuring a
+ * catalog always works.
+ */
+namespace Memory {
+
+/** @brief The most phases that can be told apart; later ones count as the
+ * first, "other" */
+static constexpr size_t MAX_PHASES{64};
+
+/** @brief What was allocated during a phase, e.g. MakeHeroes/read */
+struct Usage {
+  std::string name;
+  /** @brief the number of allocations and frees */
+  uint64_t allocations;
+  uint64_t frees;
+  /** @brief the bytes allocated in total */
+  uint64_t bytes;
+  /** @brief the bytes allocated by the phase that haven't been freed */
+  uint64_t live;
+  /** @brief the most bytes allocated by the phase not freed at once */
+  uint64_t peak;
+};
+
+/** @brief The memory used by each subsystem of a catalog, in bytes */
+struct Footprint {
+  /** @brief the number of heroes */
+  size_t heroes;
+  /** @brief the heroes, their arena and the acquisition methods */
+  size_t catalog;
+  /** @brief the index of heroes by name */
+  size_t indexes;
+  /** @brief the tier lists and their revisions */
+  size_t tier_lists;
+  /** @brief the owned heroes and their upgrades, i.e. one account's profile */
+  size_t profile;
+  /** @brief the cached filter results */
+  size_t cache;
+  /** @brief the saved views */
+  size_t views;
+
+  size_t Total() const {
+    return catalog + indexes + tier_lists + profile + cache + views;
+  }
+  /** @return the total divided by the number of heroes, or 0 */
+  double BytesPerHero() const;
+};
+
+/** @return whether allocations are counted, i.e. SDSGC_TRACK_ALLOCATIONS was
+ * defined */
+bool Tracking();
+
+/**
+ * @brief Finds a phase, making it if it doesn't exist yet. MEMORY_PHASE calls
+ * this once for each place it's used.
+ * @param &name The name of the phase
+ * @return the number of the phase
+ */
+size_t Register(const std::string &name);
+
+/** @return the phase the calling thread's allocations count as */
+size_t Current();
+
+/**
+ * @brief Counts the calling thread's allocations as the phase while it
+ * exists, instead of the phase before it. Each thread has its own phase, so
+ * phases in threads that run at the same time don't count each other's
+ * allocations. A thread starts in "other"; see Async.
+ */
+class Phase {
+public:
+  explicit Phase(size_t phase);
+  Phase(const Phase &) = delete;
+  Phase &operator=(const Phase &) = delete;
+  ~Phase();
+
+private:
+  size_t previous;
+};
+
+/**
+ * @brief Calls function with args in another thread, like std::async with
+ * std::launch::async, counting its allocations as the calling thread's phase.
+ * @return the future of the result
+ */
+template <typename Function, typename... Args>
+std::future<typename std::result_of<Function(Args...)>::type>
+Async(Function function, Args... args) {
+  size_t phase = Current();
+  return std::async(
+      std::launch::async,
+      [phase, function](Args... values) ->
+      typename std::result_of<Function(Args...)>::type {
+        Phase inherit{phase};
+        return function(values...);
+      },
+      args...);
+}
+
+/** @return every phase that allocated anything, in the order they were first
+ * used */
+std::vector<Usage> Phases();
+
+/** @brief Sets every phase's counts back to 0. Bytes still allocated are
+ * still freed from their phase. */
+void Reset();
+
+/**
+ * @brief Measures the memory a catalog's containers use, including what they
+ * allocated but don't use yet, e.g. a vector's capacity. Sizes of the nodes
+ * of maps are estimates.
+ * @param &catalog The catalog
+ * @return the memory by subsystem
+ */
+Footprint Measure(const Catalog &catalog);
+
+/**
+ * @brief Prints what each phase allocated, if allocations are counted, and the
+ * memory each subsystem of a catalog uses.
+ * @param &os Where to print it
+ * @param &catalog The catalog
+ */
+void Print(std::ostream &os, const Catalog &catalog);
+
+/**
+ * @return the phases and footprint Print prints, as a JSON document:
+ * {"tracking": true, "phases": [{"name": ..., "allocations": ..., "frees":
+ * ..., "bytes": ..., "live": ..., "peak": ...}, ...], "footprint": {"heroes":
+ * ..., "catalog": ..., ..., "total": ..., "bytes_per_hero": ...}}
+ */
+std::string ToJSON(const Catalog &catalog);
+
+/** @return the memory a string allocated, not counting itself */
+inline size_t Bytes(const std::string &str) {
+  // short strings are stored inside the string itself
+  const char *inside = reinterpret_cast<const char *>(&str);
+  if (str.data() >= inside && str.data() < inside + sizeof(str)) {
+    return 0;
+  }
+  return str.capacity() + 1;
+}
+
+/** @return the memory a vector allocated, not counting what its elements
+ * allocate */
+template <typename T> size_t Bytes(const std::vector<T> &vec) {
+  return vec.capacity() * sizeof(T);
+}
+} // namespace Memory
+
+#ifdef SDSGC_TRACK_ALLOCATIONS
+#define MEMORY_CONCAT_(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_(a, b)
+/** @brief Counts allocations in the rest of the scope as the phase name */
+#define MEMORY_PHASE(name)                                                     \
+  static const size_t MEMORY_CONCAT(memory_phase_, __LINE__) =                 \
+      Memory::Register(name);                                                  \
+  Memory::Phase MEMORY_CONCAT(memory_scope_, __LINE__) {                       \
+    MEMORY_CONCAT(memory_phase_, __LINE__)                                     \
+  }
+#else
+#define MEMORY_PHASE(name)
+#endif
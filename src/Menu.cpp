@@ -3,19 +3,36 @@
 #include <string>
 #include <vector>
 
+#include "Catalog.h"
 #include "Menu.h"
+#include "Reload.h"
+#include "Utilities.h"
+
+using Utilities::operator<<;
 
 namespace Menu {
-void TopLevelMenu() {
-  std::vector<std::string> function_names(menu_functions.size());
-  for (size_t i{0}; i < menu_functions.size(); i++) {
-    function_names[i] = menu_functions[i].name;
+void TopLevelMenu(Catalog &catalog,
+                  const std::vector<MenuFunction> &functions) {
+  std::vector<std::string> function_names(functions.size());
+  for (size_t i{0}; i < functions.size(); i++) {
+    function_names[i] = functions[i].name;
   }
 
   size_t int_input = AskForInput(
       "You can choose from the following capabilities.", function_names);
   std::cout << std::endl;
-  menu_functions[int_input - 1].function();
+
+  // use the newest data files, if they changed while waiting for input
+  std::vector<std::string> changed{};
+  if (catalog.watcher) {
+    changed = catalog.watcher->Apply(catalog);
+  }
+  if (!changed.empty()) {
+    std::cout << "Data files changed: " << changed
+              << ". Now using the new data." << std::endl
+              << std::endl;
+  }
+  functions[int_input - 1].function(catalog);
 }
 
 int GetIntInput(int min, int max) {
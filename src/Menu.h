@@ -5,13 +5,11 @@
  * @brief Implements menu and inputs.
  */
 
-#include <array>
 #include <functional>
 #include <string>
 #include <vector>
 
-#include "Filter.h"
-#include "Project.h"
+struct Catalog;
 
 namespace Menu {
 /**
@@ -20,22 +18,16 @@ namespace Menu {
  */
 struct MenuFunction {
   std::string name;
-  std::function<void()> function;
+  std::function<void(Catalog &)> function;
 };
 
-/** @brief The number of main menu functions */
-static constexpr size_t M_FUNCTIONS_COUNT{2};
-/**
- * @brief Hardcoded list of all main menu functions
- */
-const std::array<MenuFunction, M_FUNCTIONS_COUNT> menu_functions = {
-    MenuFunction{"Filter", Menu_Filter},
-    MenuFunction{"AddOwned", Menu_AddOwned}};
-
 /**
  * @brief An interactive menu to choose from the program's capabilities.
+ * @param &catalog The catalog the capabilities use
+ * @param &functions The capabilities, e.g. menu_functions in Project.h
  */
-void TopLevelMenu();
+void TopLevelMenu(Catalog &catalog,
+                  const std::vector<MenuFunction> &functions);
 
 /**
  * @brief Accepts an integer input within a given range.
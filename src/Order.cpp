@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Catalog.h"
+#include "Hero.h"
+#include "Order.h"
+#include "Stats.h"
+#include "TierLists.h"
+#include "Utilities.h"
+
+namespace Order {
+namespace {
+/** @brief The number of bits sorted by each pass of the radix sort */
+constexpr unsigned RADIX_BITS{8};
+
+/** @return the column with a name */
+const Column &FindColumn(const std::string &name) {
+  for (const Column &column : columns) {
+    if (column.name == name) {
+      return column;
+    }
+  }
+  throw std::invalid_argument("Unknown sort column " + name);
+}
+
+/** @return a number in an owned hero's upgrades, or 0 if it isn't owned */
+uint64_t Upgrade(const Hero &hero, Hero::Upgradeable upgrade) {
+  if (!hero.owned) {
+    return 0;
+  }
+  return std::strtoull(hero.upgrades[upgrade].c_str(), nullptr, 10);
+}
+
+/** @return the position of a value in a list, or the list's size */
+template <size_t N>
+uint64_t Position(const std::array<const char *, N> &values,
+                  const std::string &value) {
+  for (size_t i{0}; i < N; i++) {
+    if (value == values[i]) {
+      return i;
+    }
+  }
+  return N;
+}
+
+/** @return the total number of bits of the keys of an order */
+unsigned Bits(const std::vector<Key> &order) {
+  unsigned bits{0};
+  for (const Key &key : order) {
+    bits += FindColumn(key.column).bits;
+  }
+  if (bits > 64) {
+    throw std::invalid_argument("The sort columns need " +
+                                std::to_string(bits) +
+                                " bits, but sort keys only have 64.");
+  }
+  return bits;
+}
+
+/**
+ * @brief Sorts keys, and rows in the same order, with a least significant
+ * digit first radix sort. It's stable, so rows with equal keys stay in order.
+ * @param bits The number of low bits of the keys that are used
+ */
+void RadixSort(std::vector<uint64_t> &keys, std::vector<size_t> &rows,
+               unsigned bits) {
+  const size_t size = keys.size();
+  std::vector<uint64_t> keys_out(size);
+  std::vector<size_t> rows_out(size);
+  for (unsigned shift{0}; shift < bits; shift += RADIX_BITS) {
+    std::array<size_t, (1 << RADIX_BITS) + 1> offsets{};
+    for (uint64_t key : keys) {
+      offsets[((key >> shift) & ((1 << RADIX_BITS) - 1)) + 1]++;
+    }
+    // a pass where every key has the same digit changes nothing
+    if (std::find(offsets.begin(), offsets.end(), size) != offsets.end()) {
+      continue;
+    }
+    for (size_t i{1}; i < offsets.size(); i++) {
+      offsets[i] += offsets[i - 1];
+    }
+    for (size_t i{0}; i < size; i++) {
+      size_t &offset = offsets[(keys[i] >> shift) & ((1 << RADIX_BITS) - 1)];
+      keys_out[offset] = keys[i];
+      rows_out[offset] = rows[i];
+      offset++;
+    }
+    keys.swap(keys_out);
+    rows.swap(rows_out);
+  }
+}
+} // namespace
+
+std::vector<Key> Parse(const std::string &text) {
+  std::vector<Key> order{};
+  for (const std::string &part : Utilities::ParseCSV(text)) {
+    std::string item = Utilities::Trim(part);
+    Key key{item, false};
+    size_t space = item.find_last_of(" \t");
+    if (space != std::string::npos) {
+      std::string direction = item.substr(space + 1);
+      std::transform(direction.begin(), direction.end(), direction.begin(),
+                     ::toupper);
+      if (direction == "DESC" || direction == "ASC") {
+        key = {Utilities::Trim(item.substr(0, space)), direction == "DESC"};
+      }
+    }
+    FindColumn(key.column);
+    order.push_back(key);
+  }
+  if (order.empty()) {
+    throw std::invalid_argument("The order has no columns.");
+  }
+  Bits(order);
+  return order;
+}
+
+std::string ToString(const std::vector<Key> &order) {
+  std::string out{};
+  for (size_t i{0}; i < order.size(); i++) {
+    out += (i == 0 ? "" : ", ") + order[i].column +
+           (order[i].descending ? " DESC" : "");
+  }
+  return out;
+}
+
+std::vector<uint64_t> MakeKeys(const Catalog &catalog,
+                               const std::vector<size_t> &rows,
+                               const std::vector<Key> &order) {
+  STATS_TIMER("Order/MakeKeys");
+  Bits(order);
+  std::vector<const Column *> used{};
+  for (const Key &key : order) {
+    used.push_back(&FindColumn(key.column));
+  }
+  // each hero is read once, for every column, as heroes are large
+  std::vector<uint64_t> keys(rows.size(), 0);
+  for (size_t i{0}; i < rows.size(); i++) {
+    const Hero &hero = catalog.list[rows[i]];
+    uint64_t key{0};
+    for (size_t j{0}; j < used.size(); j++) {
+      const uint64_t max = (uint64_t{1} << used[j]->bits) - 1;
+      uint64_t value = std::min(used[j]->value(catalog, hero), max);
+      key = (key << used[j]->bits) | (order[j].descending ? max - value
+                                                          : value);
+    }
+    keys[i] = key;
+  }
+  return keys;
+}
+
+std::vector<size_t> Sort(const Catalog &catalog, std::vector<size_t> rows,
+                         const std::vector<Key> &order) {
+  STATS_TIMER("Order/Sort");
+  std::vector<uint64_t> keys = MakeKeys(catalog, rows, order);
+  RadixSort(keys, rows, Bits(order));
+  return rows;
+}
+
+std::vector<size_t> Top(const Catalog &catalog,
+                        const std::vector<size_t> &rows,
+                        const std::vector<Key> &order, size_t count) {
+  STATS_TIMER("Order/Top");
+  if (count >= rows.size()) {
+    return Sort(catalog, rows, order);
+  }
+  std::vector<uint64_t> keys = MakeKeys(catalog, rows, order);
+  // equal keys are ordered by their position, so the result is stable
+  std::vector<std::pair<uint64_t, size_t>> items(rows.size());
+  for (size_t i{0}; i < rows.size(); i++) {
+    items[i] = {keys[i], i};
+  }
+  std::partial_sort(items.begin(),
+                    items.begin() + static_cast<std::ptrdiff_t>(count),
+                    items.end());
+  std::vector<size_t> out(count);
+  for (size_t i{0}; i < count; i++) {
+    out[i] = rows[items[i].second];
+  }
+  return out;
+}
+
+uint64_t BestTier(const Catalog &catalog, const Hero &hero) {
+  uint64_t best{Hero::MAX_TIER + 1};
+  for (const TierLists::TierList &list : catalog.tier_lists) {
+    int tier = list.Latest()[hero.index];
+    if (tier > 0 && static_cast<uint64_t>(tier) < best) {
+      best = static_cast<uint64_t>(tier);
+    }
+  }
+  return best;
+}
+
+uint64_t StartingGrade(const Catalog &, const Hero &hero) {
+  return Position(Hero::StartingGrades::VALUES, hero.starting_grade.str());
+}
+
+uint64_t Owned(const Catalog &, const Hero &hero) { return hero.owned; }
+
+uint64_t Grade(const Catalog &, const Hero &hero) {
+  if (!hero.owned) {
+    return 0;
+  }
+  return 1 + Position(Hero::Grades::VALUES, hero.upgrades[Hero::GRADE]);
+}
+
+uint64_t Level(const Catalog &, const Hero &hero) {
+  return Upgrade(hero, Hero::LEVEL);
+}
+
+uint64_t Stars(const Catalog &, const Hero &hero) {
+  return Upgrade(hero, Hero::STARS);
+}
+
+uint64_t Unique(const Catalog &, const Hero &hero) {
+  return hero.owned && hero.upgrades[Hero::UNIQUE] == "true";
+}
+
+uint64_t Ultimate(const Catalog &, const Hero &hero) {
+  return Upgrade(hero, Hero::ULTIMATE);
+}
+} // namespace Order
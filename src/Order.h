@@ -0,0 +1,139 @@
+/**
+ * @file Order.h
+ * @brief Order namespace sorts heroes by several columns, e.g. best tier,
+ * then grade, then ultimate level, or finds the first few in that order.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Hero.h"
+
+struct Catalog;
+
+/**
+ * @brief Order namespace sorts heroes by several columns. Each hero's values
+ * of the columns are packed into one integer, its sort key, once per sort, so
+ * heroes are compared by comparing integers. Whole lists are sorted with a
+ * radix sort, and the first few heroes are found with a partial sort. Heroes
+ * with equal keys stay in the order they were given in.
+ */
+namespace Order {
+
+/** @brief Column lets me easily name and use sort columns at runtime. */
+struct Column {
+  /** @brief a name for the column */
+  std::string name;
+  /** @brief the number of bits its values need */
+  unsigned bits;
+  /** @brief its value for a hero, less than 2^bits. Smaller values come first
+   * unless the order is descending. */
+  std::function<uint64_t(const Catalog &, const Hero &)> value;
+};
+
+/** @brief A column to sort by, and its direction */
+struct Key {
+  std::string column;
+  bool descending;
+};
+
+/**
+ * @brief Reads an order from text, e.g. BestTier, Grade DESC, Ultimate DESC.
+ * Columns are ascending unless followed by DESC; ASC can also be written.
+ * @param &text The order
+ * @return the keys, first the one compared first
+ * @throw std::invalid_argument if a column doesn't exist, or the columns need
+ * more than 64 bits
+ */
+std::vector<Key> Parse(const std::string &text);
+
+/**
+ * @param &order An order
+ * @return the order as text, the opposite of Parse
+ */
+std::string ToString(const std::vector<Key> &order);
+
+/**
+ * @brief Makes the sort key of each hero: the values of the columns packed
+ * into an integer, the first column in the highest bits.
+ * @param &catalog The catalog the heroes are in
+ * @param &rows The indices of the heroes in Catalog::list
+ * @param &order The order
+ * @return the key of each hero in rows
+ * @throw std::invalid_argument if a column doesn't exist, or the columns need
+ * more than 64 bits
+ */
+std::vector<uint64_t> MakeKeys(const Catalog &catalog,
+                               const std::vector<size_t> &rows,
+                               const std::vector<Key> &order);
+
+/**
+ * @brief Sorts heroes with a radix sort of their keys.
+ * @param &catalog The catalog the heroes are in
+ * @param rows The indices of the heroes in Catalog::list
+ * @param &order The order
+ * @return the indices, sorted
+ * @throw std::invalid_argument if the order is invalid
+ */
+std::vector<size_t> Sort(const Catalog &catalog, std::vector<size_t> rows,
+                         const std::vector<Key> &order);
+
+/**
+ * @brief Finds the first heroes in an order, without sorting the rest.
+ * @param &catalog The catalog the heroes are in
+ * @param &rows The indices of the heroes in Catalog::list
+ * @param &order The order
+ * @param count The number of heroes to find
+ * @return the indices of the first count heroes, sorted
+ * @throw std::invalid_argument if the order is invalid
+ */
+std::vector<size_t> Top(const Catalog &catalog,
+                        const std::vector<size_t> &rows,
+                        const std::vector<Key> &order, size_t count);
+
+/**
+ * @name Columns
+ * @brief All columns take the catalog and a hero, and return the hero's
+ * value. The owned columns are 0 for heroes that aren't owned. All the columns
+ * are hardcoded in the list columns.
+ * @{
+ */
+
+/** @return the best (lowest) tier on any tier list, or Hero::MAX_TIER + 1 if
+ * the hero is unranked on all of them */
+uint64_t BestTier(const Catalog &catalog, const Hero &hero);
+
+/** @return the position of the starting grade in R, SR, SSR, UR */
+uint64_t StartingGrade(const Catalog &catalog, const Hero &hero);
+
+/** @return 1 if the hero is owned */
+uint64_t Owned(const Catalog &catalog, const Hero &hero);
+
+/** @return 1 + the position of the owned grade in R, SR, SSR, UR, LR */
+uint64_t Grade(const Catalog &catalog, const Hero &hero);
+
+/** @return the owned level */
+uint64_t Level(const Catalog &catalog, const Hero &hero);
+
+/** @return the owned stars */
+uint64_t Stars(const Catalog &catalog, const Hero &hero);
+
+/** @return 1 if the owned hero's unique is unlocked */
+uint64_t Unique(const Catalog &catalog, const Hero &hero);
+
+/** @return the owned ultimate level */
+uint64_t Ultimate(const Catalog &catalog, const Hero &hero);
+
+/**@}*/
+
+/** @brief Hardcoded list of all columns */
+const std::vector<Column> columns = {
+    {"BestTier", 3, BestTier}, {"StartingGrade", 2, StartingGrade},
+    {"Owned", 1, Owned},       {"Grade", 3, Grade},
+    {"Level", 7, Level},       {"Stars", 4, Stars},
+    {"Unique", 1, Unique},     {"Ultimate", 3, Ultimate}};
+} // namespace Order
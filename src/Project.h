@@ -1,11 +1,18 @@
 /**
  * @file Project.h
- * @brief The main menu functions. They are in the list Menu::menu_functions.
- * The lists need to stay updated - they're what the program uses.
+ * @brief The main menu functions of the program, which is a front end to the
+ * sdsgc library. They are in the list Menu::menu_functions. The lists need to
+ * stay updated - they're what the program uses.
  */
 
 #pragma once
 
+#include <vector>
+
+#include "Menu.h"
+
+struct Catalog;
+
 /**
  * This top-level menu option allows you to filter heroes by a selection of
  * conditions. This includes the option to select as many conditions as you
@@ -13,10 +20,65 @@
  * keeps track of the conditions selected so that it can be printed. This is the
  * order, left-to-right, that the conditions are evaluated.
  */
-void Menu_Filter();
+void Menu_Filter(Catalog &catalog);
 
 /**
  * This top-level menu option allows you to update your owned heros data in the
  * program and data file, by going through a list of heroes.
  */
-void Menu_AddOwned();
\ No newline at end of file
+void Menu_AddOwned(Catalog &catalog);
+
+/**
+ * This top-level menu option allows you to save filters as views, whose
+ * results are kept up to date when you update your owned heroes, and to see
+ * the results of saved views.
+ */
+void Menu_Views(Catalog &catalog);
+
+/**
+ * This top-level menu option shows how well the filter result cache is
+ * working, and allows you to change its size.
+ */
+void Menu_Cache(Catalog &catalog);
+
+/**
+ * This top-level menu option shows how a filter is evaluated: how many heroes
+ * each of its conditions and operations checks and finds, estimated and
+ * actual, and how long each takes.
+ */
+void Menu_Explain(Catalog &catalog);
+
+/**
+ * This top-level menu option finds heroes, names and characters from part of
+ * their text, even with typos, and shows the heroes of the one you choose.
+ */
+void Menu_Search(Catalog &catalog);
+
+/**
+ * This top-level menu option summarizes the heroes a filter finds in a table,
+ * e.g. the number of heroes of each attribute and starting grade that you own,
+ * or the average ultimate level of each race.
+ */
+void Menu_Aggregate(Catalog &catalog);
+
+/**
+ * This top-level menu option compares a file of owned heroes, e.g. an old
+ * owned.csv or another account's, with another one or with your owned heroes,
+ * and shows the heroes added, removed and changed.
+ */
+void Menu_Compare(Catalog &catalog);
+
+namespace Menu {
+/**
+ * @brief Hardcoded list of all main menu functions
+ */
+const std::vector<MenuFunction> menu_functions = {
+    MenuFunction{"Filter", Menu_Filter},
+    MenuFunction{"AddOwned", Menu_AddOwned},
+    MenuFunction{"Views", Menu_Views},
+    MenuFunction{"Cache", Menu_Cache},
+    MenuFunction{"Explain", Menu_Explain},
+    MenuFunction{"Search", Menu_Search},
+    MenuFunction{"Aggregate", Menu_Aggregate},
+    MenuFunction{"Compare", Menu_Compare}};
+} // namespace Menu
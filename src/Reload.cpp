@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catalog.h"
+#include "Heroes.h"
+#include "Reload.h"
+#include "Views.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Reload {
+
+namespace {
+/** @brief The data files that are watched */
+const std::vector<std::string> WATCHED{"heroes.csv", "acquisition.txt",
+                                       "draws.txt", "tiers.csv"};
+
+#ifdef __linux__
+/**
+ * @brief Reads the available inotify events, adding the names of changed
+ * watched files to changed.
+ * @return whether there were any events
+ */
+bool ReadEvents(int fd, std::vector<std::string> &changed) {
+  alignas(struct inotify_event) char buffer[4096];
+  ssize_t length = read(fd, buffer, sizeof buffer);
+  if (length <= 0) {
+    return false;
+  }
+  for (char *ptr{buffer}; ptr < buffer + length;) {
+    const struct inotify_event *event =
+        reinterpret_cast<const struct inotify_event *>(ptr);
+    if (event->len > 0) {
+      std::string name{event->name};
+      if (std::find(WATCHED.begin(), WATCHED.end(), name) != WATCHED.end() &&
+          std::find(changed.begin(), changed.end(), name) == changed.end()) {
+        changed.push_back(name);
+      }
+    }
+    ptr += sizeof(struct inotify_event) + event->len;
+  }
+  return true;
+}
+#endif
+} // namespace
+
+Watcher::Watcher(const std::string &data_dir)
+    : data_dir{data_dir}, mutex{}, pending{}, pending_files{}, stopping{false},
+      thread{} {}
+
+Watcher::~Watcher() { Stop(); }
+
+#ifdef __linux__
+void Watcher::Watch(int fd) {
+  // what was read from each file, so unchanged files aren't read again. Owned
+  // heroes are kept from the dataset in use (see Heroes::Install), so
+  // owned.csv isn't needed.
+  Heroes::Sources sources{};
+  try {
+    sources.acquisition = Heroes::ReadAcquisitionData(data_dir);
+    sources.heroes = Heroes::ReadHeroesData(data_dir);
+    sources.tiers = Heroes::ReadTiersData(data_dir);
+  } catch (std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+  }
+
+  struct pollfd poll_fd {
+    fd, POLLIN, 0
+  };
+  while (!stopping) {
+    // wait for a change, checking regularly whether to stop
+    if (poll(&poll_fd, 1, 100) <= 0) {
+      continue;
+    }
+    std::vector<std::string> changed{};
+    ReadEvents(fd, changed);
+    if (changed.empty()) {
+      continue;
+    }
+    // wait until the files stop changing
+    while (poll(&poll_fd, 1, SETTLE_MILLISECONDS) > 0) {
+      ReadEvents(fd, changed);
+    }
+
+    // read only the changed files, then make and validate the new dataset
+    try {
+      Heroes::Sources next = sources;
+      auto has_changed = [&changed](const std::string &name) {
+        return std::find(changed.begin(), changed.end(), name) !=
+               changed.end();
+      };
+      if (has_changed("acquisition.txt") || has_changed("draws.txt")) {
+        next.acquisition = Heroes::ReadAcquisitionData(data_dir);
+      }
+      if (has_changed("heroes.csv")) {
+        next.heroes = Heroes::ReadHeroesData(data_dir);
+      }
+      if (has_changed("tiers.csv")) {
+        next.tiers = Heroes::ReadTiersData(data_dir);
+      }
+      std::unique_ptr<Heroes::Dataset> dataset{new Heroes::Dataset{}};
+      Heroes::MakeDataset(next, *dataset);
+      sources = next;
+
+      std::lock_guard<std::mutex> lock{mutex};
+      pending = std::move(dataset);
+      for (const std::string &name : changed) {
+        if (std::find(pending_files.begin(), pending_files.end(), name) ==
+            pending_files.end()) {
+          pending_files.push_back(name);
+        }
+      }
+    } catch (std::exception &ex) {
+      std::cerr << "The data files changed, but the new data can't be used. "
+                << ex.what() << std::endl;
+    }
+  }
+  close(fd);
+}
+#else
+void Watcher::Watch(int /* fd */) {}
+#endif
+
+void Watcher::Start() {
+#ifdef __linux__
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  // editors often replace files instead of writing them, hence IN_MOVED_TO
+  if (inotify_add_watch(fd, data_dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) <
+      0) {
+    close(fd);
+    return;
+  }
+  stopping = false;
+  thread = std::thread{&Watcher::Watch, this, fd};
+#endif
+}
+
+void Watcher::Stop() {
+  stopping = true;
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+std::vector<std::string> Watcher::Apply(Catalog &catalog) {
+  std::unique_ptr<Heroes::Dataset> dataset{};
+  std::vector<std::string> files{};
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    std::swap(dataset, pending);
+    std::swap(files, pending_files);
+  }
+  if (dataset) {
+    Heroes::Install(catalog, *dataset);
+    Views::Rebuild(catalog);
+  }
+  return files;
+}
+} // namespace Reload
@@ -0,0 +1,90 @@
+/**
+ * @file Reload.h
+ * @brief Reload namespace watches the data directory while the program runs,
+ * and reads the data files again when they change, e.g. when draws.txt is
+ * updated for a new banner. (Only on Linux, where it uses inotify.)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Heroes.h"
+
+struct Catalog;
+
+/**
+ * @brief Reload namespace watches the data directory while the program runs,
+ * and reads the data files again when they change.
+ */
+namespace Reload {
+
+/** @brief How long to wait for more changes after a file changes, since
+ * programs often write a file in several steps */
+static constexpr int SETTLE_MILLISECONDS{50};
+
+/**
+ * @brief Watches one data directory, for the catalog made from it.
+ * @see Catalog::watcher
+ */
+class Watcher {
+public:
+  /**
+   * @param &data_dir The directory to watch
+   */
+  explicit Watcher(const std::string &data_dir);
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+
+  /** @brief Stops watching */
+  ~Watcher();
+
+  /**
+   * @brief Starts watching heroes.csv, acquisition.txt, draws.txt and
+   * tiers.csv in a separate thread. When they change, only the changed files
+   * are read again, and a new dataset is made and validated in that thread.
+   * It's used when Apply is called. If the new data is invalid, the message is
+   * printed and the data in use is kept. owned.csv isn't watched, since the
+   * program writes it. Does nothing if watching isn't supported.
+   */
+  void Start();
+
+  /** @brief Stops watching the data directory. */
+  void Stop();
+
+  /**
+   * @brief Installs the dataset made since the data files last changed, if
+   * there is one, and updates the saved views. It should be called when
+   * nothing is using the heroes, so they never see half of each dataset.
+   * @param &catalog The catalog to install it in
+   * @return the names of the files that changed, or an empty list if nothing
+   * changed
+   * @see Heroes::Install
+   */
+  std::vector<std::string> Apply(Catalog &catalog);
+
+private:
+  /** @brief The watching thread */
+  void Watch(int fd);
+
+  std::string data_dir;
+
+  /** @brief Protects pending and pending_files */
+  std::mutex mutex;
+
+  /** @brief The dataset made since the data files last changed */
+  std::unique_ptr<Heroes::Dataset> pending;
+
+  /** @brief The names of the files that changed for pending */
+  std::vector<std::string> pending_files;
+
+  std::atomic<bool> stopping;
+
+  std::thread thread;
+};
+} // namespace Reload
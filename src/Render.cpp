@@ -0,0 +1,501 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Catalog.h"
+#include "Hero.h"
+#include "Render.h"
+#include "Stats.h"
+#include "TierLists.h"
+
+namespace Render {
+namespace {
+/** @brief The columns of Headings before the tier lists, and after them */
+const std::vector<std::string> FIRST_HEADINGS{
+    "Hero", "Name",  "Attribute", "StartingGrade",
+    "Character", "LR", "Races", "Characteristic"};
+const std::vector<std::string> LAST_HEADINGS{
+    "Owned", "Grade", "Level", "Stars", "Unique", "Ultimate", "Acquisition"};
+
+/** @brief The names of the upgrades in JSON, indexed by Hero::Upgradeable */
+const std::array<const char *, Hero::UPGRADES_COUNT> UPGRADE_NAMES{
+    {"grade", "level", "stars", "unique", "ultimate"}};
+
+/** @brief Appends a number without making a string for it */
+void AppendNumber(std::string &out, long long number) {
+  if (number < 0) {
+    out += '-';
+    number = -number;
+  }
+  char digits[20];
+  size_t count{0};
+  do {
+    digits[count++] = static_cast<char>('0' + number % 10);
+    number /= 10;
+  } while (number != 0);
+  while (count != 0) {
+    out += digits[--count];
+  }
+}
+
+/** @brief Appends the texts of a list separated by commas */
+void AppendList(std::string &out, const Span<Text> &list) {
+  for (size_t i{0}; i < list.size(); i++) {
+    if (i != 0) {
+      out += ", ";
+    }
+    out.append(list[i].data(), list[i].size());
+  }
+}
+
+/** @brief Appends a CSV value, quoted like Utilities::MakeCSV */
+void AppendCSV(std::string &out, const char *begin, const char *end) {
+  if (std::find_if(begin, end, [](char ch) {
+        return ch == '"' || ch == ',' || ch == '\n';
+      }) == end) {
+    out.append(begin, end);
+    return;
+  }
+  // quotes are escaped with another quote
+  out += '"';
+  for (const char *quote = std::find(begin, end, '"'); quote != end;
+       quote = std::find(begin, end, '"')) {
+    out.append(begin, quote + 1);
+    out += '"';
+    begin = quote + 1;
+  }
+  out.append(begin, end);
+  out += '"';
+}
+
+/** @brief Appends a JSON string, with its quotes */
+void AppendJSON(std::string &out, const char *begin, const char *end) {
+  static const char HEX[]{"0123456789abcdef"};
+  auto special = [](char ch) {
+    return ch == '"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+  };
+  // the text between special characters is copied at once
+  out += '"';
+  for (const char *ch = std::find_if(begin, end, special); ch != end;
+       ch = std::find_if(begin, end, special)) {
+    out.append(begin, ch);
+    if (*ch == '"' || *ch == '\\') {
+      out += '\\';
+      out += *ch;
+    } else {
+      out += "\\u00";
+      out += HEX[(*ch >> 4) & 0xF];
+      out += HEX[*ch & 0xF];
+    }
+    begin = ch + 1;
+  }
+  out.append(begin, end);
+  out += '"';
+}
+
+void AppendJSON(std::string &out, const Text &text) {
+  AppendJSON(out, text.begin(), text.end());
+}
+
+void AppendJSON(std::string &out, const std::string &str) {
+  AppendJSON(out, str.data(), str.data() + str.size());
+}
+
+void AppendJSON(std::string &out, const Span<Text> &list) {
+  out += '[';
+  for (size_t i{0}; i < list.size(); i++) {
+    if (i != 0) {
+      out += ", ";
+    }
+    AppendJSON(out, list[i]);
+  }
+  out += ']';
+}
+
+/** @brief Appends a hero as a JSON object */
+void AppendJSON(std::string &out, const Catalog &catalog, const Hero &hero) {
+  out += "{\"hero\": ";
+  AppendJSON(out, hero.hero);
+  out += ", \"name\": ";
+  AppendJSON(out, hero.name);
+  out += ", \"attribute\": ";
+  AppendJSON(out, hero.attribute);
+  out += ", \"starting_grade\": ";
+  AppendJSON(out, hero.starting_grade);
+  out += ", \"character\": ";
+  AppendJSON(out, hero.character);
+  out += hero.lr ? ", \"lr\": true" : ", \"lr\": false";
+  out += ", \"races\": ";
+  AppendJSON(out, hero.races);
+  out += ", \"characteristic\": ";
+  AppendJSON(out, hero.characteristic);
+  out += ", \"tiers\": {";
+  for (size_t i{0}; i < catalog.tier_lists.size(); i++) {
+    if (i != 0) {
+      out += ", ";
+    }
+    AppendJSON(out, catalog.tier_lists[i].Name());
+    out += ": ";
+    AppendNumber(out, catalog.tier_lists[i].Latest()[hero.index]);
+  }
+  out += '}';
+  if (hero.owned) {
+    // owned.csv is checked against Hero::UpgradesSchema, so the numbers and
+    // bool are valid JSON
+    out += ", \"owned\": true, \"grade\": ";
+    AppendJSON(out, hero.upgrades[Hero::GRADE]);
+    for (Hero::Upgradeable upgrade :
+         {Hero::LEVEL, Hero::STARS, Hero::UNIQUE, Hero::ULTIMATE}) {
+      out += ", \"";
+      out += UPGRADE_NAMES[upgrade];
+      out += "\": ";
+      out += hero.upgrades[upgrade];
+    }
+  } else {
+    out += ", \"owned\": false, \"grade\": null, \"level\": null, "
+           "\"stars\": null, \"unique\": null, \"ultimate\": null";
+  }
+  out += ", \"acquisition\": ";
+  AppendJSON(out, hero.acquisition);
+  out += '}';
+}
+
+/**
+ * @return whether a cell is a number as JSON writes it: an optional minus, an
+ * integer part without leading zeros, and optionally a point and a fraction,
+ * e.g. -0.5 but not 080, 5. or .5
+ */
+bool IsJSONNumber(const std::string &cell) {
+  size_t i = cell.compare(0, 1, "-") == 0 ? 1 : 0;
+  auto digits = [&cell, &i]() {
+    size_t begin = i;
+    while (i < cell.size() && cell[i] >= '0' && cell[i] <= '9') {
+      i++;
+    }
+    return i - begin;
+  };
+  size_t integer_begin = i;
+  size_t integer = digits();
+  if (integer == 0 || (integer > 1 && cell[integer_begin] == '0')) {
+    return false;
+  }
+  if (i < cell.size() && cell[i] == '.') {
+    i++;
+    if (digits() == 0) {
+      return false;
+    }
+  }
+  return i == cell.size();
+}
+
+/** @return the number of characters in UTF-8 text */
+size_t Width(const char *begin, const char *end) {
+  return static_cast<size_t>(std::count_if(begin, end, [](char ch) {
+    return (static_cast<unsigned char>(ch) & 0xC0) != 0x80;
+  }));
+}
+
+/** @brief Appends a cell of a table and the spaces after it */
+void AppendCell(std::string &out, const char *begin, const char *end,
+                size_t width, bool last) {
+  out.append(begin, end);
+  if (!last) {
+    out.append(width - Width(begin, end) + 2, ' ');
+  }
+}
+
+/**
+ * @brief Calls cell with the beginning and end of each column of Headings for
+ * a hero. Texts of the hero are given as they are; other columns are
+ * formatted into scratch first.
+ */
+template <typename Function>
+void ForEachCell(const Catalog &catalog, const Hero &hero, std::string &scratch,
+                 Function cell) {
+  auto formatted = [&scratch, &cell]() {
+    cell(scratch.data(), scratch.data() + scratch.size());
+    scratch.clear();
+  };
+  auto boolean = [&cell](bool value) {
+    const char *str = value ? "true" : "false";
+    cell(str, str + std::strlen(str));
+  };
+  for (const Text *text : {&hero.hero, &hero.name, &hero.attribute,
+                           &hero.starting_grade, &hero.character}) {
+    cell(text->begin(), text->end());
+  }
+  boolean(hero.lr);
+  AppendList(scratch, hero.races);
+  formatted();
+  cell(hero.characteristic.begin(), hero.characteristic.end());
+  for (const TierLists::TierList &list : catalog.tier_lists) {
+    AppendNumber(scratch, list.Latest()[hero.index]);
+    formatted();
+  }
+  boolean(hero.owned);
+  for (const std::string &upgrade : hero.upgrades) {
+    // unowned heroes' upgrades are empty
+    const char *begin = hero.owned ? upgrade.data() : "";
+    cell(begin, begin + (hero.owned ? upgrade.size() : 0));
+  }
+  AppendList(scratch, hero.acquisition);
+  formatted();
+}
+} // namespace
+
+Format ParseFormat(const std::string &name) {
+  if (name == "names") {
+    return Format::NAMES;
+  } else if (name == "text") {
+    return Format::TEXT;
+  } else if (name == "csv") {
+    return Format::CSV;
+  } else if (name == "jsonl") {
+    return Format::JSONL;
+  } else if (name == "table") {
+    return Format::TABLE;
+  }
+  throw std::invalid_argument("Unknown format " + name +
+                              ". The formats are names, text, csv, jsonl and "
+                              "table.");
+}
+
+std::vector<std::string> Headings(const Catalog &catalog) {
+  std::vector<std::string> headings = FIRST_HEADINGS;
+  for (const TierLists::TierList &tier_list : catalog.tier_lists) {
+    headings.push_back(tier_list.Name());
+  }
+  headings.insert(headings.end(), LAST_HEADINGS.begin(), LAST_HEADINGS.end());
+  return headings;
+}
+
+void AppendText(std::string &out, const Catalog &catalog, const Hero &hero) {
+  out += "Hero: ";
+  out.append(hero.hero.data(), hero.hero.size());
+  out += ". Name: ";
+  out.append(hero.name.data(), hero.name.size());
+  out += ". Attribute: ";
+  out.append(hero.attribute.data(), hero.attribute.size());
+  out += ". Starting grade: ";
+  out.append(hero.starting_grade.data(), hero.starting_grade.size());
+  out += ". Character: ";
+  out.append(hero.character.data(), hero.character.size());
+  out += ", race(s) ";
+  AppendList(out, hero.races);
+  out += ", of ";
+  out.append(hero.characteristic.data(), hero.characteristic.size());
+  out += ". ";
+  for (const TierLists::TierList &list : catalog.tier_lists) {
+    int tier = list.Latest()[hero.index];
+    if (tier != 0) {
+      out += "Tier ";
+      AppendNumber(out, tier);
+      out += " on ";
+      out += list.Name();
+      out += " tier list. ";
+    }
+  }
+  if (hero.owned) {
+    out += "I already own this hero at ultimate level ";
+    out += hero.upgrades[Hero::ULTIMATE];
+    out += ".";
+  } else if (hero.acquisition.empty()) {
+    out += "This hero is not currently acquirable.";
+  } else {
+    out += "This hero is acquired by ";
+    AppendList(out, hero.acquisition);
+    out += ".";
+  }
+}
+
+void WriteTable(std::ostream &os, const std::vector<std::string> &headings,
+                const std::vector<std::vector<std::string>> &rows,
+                Format format) {
+  STATS_TIMER("Render/WriteTable");
+  std::string out{};
+  switch (format) {
+  case Format::CSV:
+    for (size_t i{0}; i <= rows.size(); i++) {
+      const std::vector<std::string> &row = i == 0 ? headings : rows[i - 1];
+      for (size_t j{0}; j < row.size(); j++) {
+        if (j != 0) {
+          out += ',';
+        }
+        AppendCSV(out, row[j].data(), row[j].data() + row[j].size());
+      }
+      out += '\n';
+    }
+    break;
+  case Format::JSONL:
+    for (const std::vector<std::string> &row : rows) {
+      out += '{';
+      for (size_t j{0}; j < row.size() && j < headings.size(); j++) {
+        out += j == 0 ? "" : ", ";
+        AppendJSON(out, headings[j]);
+        out += ": ";
+        if (row[j].empty()) {
+          out += "null";
+        } else if (IsJSONNumber(row[j])) {
+          out += row[j];
+        } else {
+          AppendJSON(out, row[j]);
+        }
+      }
+      out += "}\n";
+    }
+    break;
+  case Format::NAMES:
+  case Format::TEXT:
+  case Format::TABLE: {
+    std::vector<size_t> widths(headings.size(), 0);
+    for (size_t i{0}; i <= rows.size(); i++) {
+      const std::vector<std::string> &row = i == 0 ? headings : rows[i - 1];
+      for (size_t j{0}; j < row.size() && j < widths.size(); j++) {
+        widths[j] = std::max(
+            widths[j], Width(row[j].data(), row[j].data() + row[j].size()));
+      }
+    }
+    for (size_t i{0}; i <= rows.size(); i++) {
+      const std::vector<std::string> &row = i == 0 ? headings : rows[i - 1];
+      for (size_t j{0}; j < row.size() && j < widths.size(); j++) {
+        AppendCell(out, row[j].data(), row[j].data() + row[j].size(),
+                   widths[j], j + 1 == widths.size());
+      }
+      out += '\n';
+      if (i == 0) {
+        for (size_t j{0}; j < widths.size(); j++) {
+          out.append(widths[j], '-');
+          out.append(j + 1 == widths.size() ? 0 : 2, ' ');
+        }
+        out += '\n';
+      }
+    }
+    break;
+  }
+  }
+  os.write(out.data(), static_cast<std::streamsize>(out.size()));
+  os.flush();
+}
+
+Renderer::Renderer(std::ostream &os, const Catalog &catalog, Format format)
+    : os{os}, catalog{catalog}, format{format}, buffer{}, started{false},
+      scratch{}, cells{}, ends{}, widths{} {
+  buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+}
+
+Renderer::~Renderer() { Finish(); }
+
+void Renderer::Add(const Hero &hero) {
+  switch (format) {
+  case Format::NAMES:
+    buffer.append(hero.hero.data(), hero.hero.size());
+    break;
+  case Format::TEXT:
+    AppendText(buffer, catalog, hero);
+    break;
+  case Format::CSV: {
+    if (!started) {
+      std::vector<std::string> headings = Headings(catalog);
+      for (size_t i{0}; i < headings.size(); i++) {
+        if (i != 0) {
+          buffer += ',';
+        }
+        AppendCSV(buffer, headings[i].data(),
+                  headings[i].data() + headings[i].size());
+      }
+      buffer += '\n';
+      started = true;
+    }
+    bool first{true};
+    ForEachCell(catalog, hero, scratch, [this, &first](const char *begin,
+                                                       const char *end) {
+      if (!first) {
+        buffer += ',';
+      }
+      first = false;
+      AppendCSV(buffer, begin, end);
+    });
+    break;
+  }
+  case Format::JSONL:
+    AppendJSON(buffer, catalog, hero);
+    break;
+  case Format::TABLE: {
+    // the width of each column is found as the cells are added, so the table
+    // is written without going over them again
+    size_t column{0};
+    ForEachCell(catalog, hero, scratch, [this, &column](const char *begin,
+                                                        const char *end) {
+      if (widths.size() <= column) {
+        widths.resize(column + 1, 0);
+      }
+      widths[column] = std::max(widths[column], Width(begin, end));
+      cells.append(begin, end);
+      ends.push_back(cells.size());
+      column++;
+    });
+    return;
+  }
+  }
+  buffer += '\n';
+  if (buffer.size() >= BUFFER_SIZE) {
+    Flush();
+  }
+}
+
+void Renderer::Add(const std::vector<size_t> &rows) {
+  for (size_t index : rows) {
+    Add(catalog.list[index]);
+  }
+}
+
+void Renderer::Flush() {
+  STATS_TIMER("Render/write");
+  os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  buffer.clear();
+}
+
+void Renderer::Finish() {
+  if (format == Format::TABLE) {
+    std::vector<std::string> headings = Headings(catalog);
+    widths.resize(headings.size(), 0);
+    for (size_t i{0}; i < headings.size(); i++) {
+      widths[i] = std::max(widths[i],
+                           Width(headings[i].data(),
+                                 headings[i].data() + headings[i].size()));
+    }
+    const size_t columns = headings.size();
+    for (size_t i{0}; i < columns; i++) {
+      const std::string &heading = headings[i];
+      AppendCell(buffer, heading.data(), heading.data() + heading.size(),
+                 widths[i], i + 1 == columns);
+    }
+    buffer += '\n';
+    for (size_t i{0}; i < columns; i++) {
+      buffer.append(widths[i], '-');
+      buffer.append(i + 1 == columns ? 0 : 2, ' ');
+    }
+    buffer += '\n';
+    size_t begin{0};
+    for (size_t i{0}; i < ends.size(); i++) {
+      AppendCell(buffer, cells.data() + begin, cells.data() + ends[i],
+                 widths[i % columns], (i + 1) % columns == 0);
+      begin = ends[i];
+      if ((i + 1) % columns == 0) {
+        buffer += '\n';
+        if (buffer.size() >= BUFFER_SIZE) {
+          Flush();
+        }
+      }
+    }
+    cells.clear();
+    ends.clear();
+    widths.clear();
+  }
+  Flush();
+  os.flush();
+}
+} // namespace Render
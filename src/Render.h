@@ -0,0 +1,128 @@
+/**
+ * @file Render.h
+ * @brief Render namespace writes heroes as text, CSV, JSON Lines or a table,
+ * formatting many heroes into one buffer before writing it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Catalog;
+struct Hero;
+
+/**
+ * @brief Render namespace writes heroes in several formats. A Renderer appends
+ * each hero to a buffer that's reused, and only writes the buffer when it's
+ * full or finished, so writing many heroes takes few writes to the stream
+ * instead of dozens of small ones for each hero.
+ */
+namespace Render {
+
+/** @brief The size the buffer grows to before it's written */
+static constexpr size_t BUFFER_SIZE{1 << 20};
+
+/** @brief The formats heroes can be written in */
+enum class Format {
+  /** @brief the name of each hero (Hero::hero) */
+  NAMES,
+  /** @brief the sentences of Hero::Print */
+  TEXT,
+  /** @brief a row of the columns of Headings for each hero, after a row of
+   * the headings, quoted like Utilities::MakeCSV */
+  CSV,
+  /** @brief a JSON object for each hero */
+  JSONL,
+  /** @brief the columns of Headings, lined up */
+  TABLE
+};
+
+/**
+ * @param &name names, text, csv, jsonl or table
+ * @return the format
+ * @throw std::invalid_argument if it isn't a format
+ */
+Format ParseFormat(const std::string &name);
+
+/**
+ * @param &catalog The catalog, for the names of its tier lists
+ * @return the columns of the CSV and table formats: Hero, Name, Attribute,
+ * StartingGrade, Character, LR, Races, Characteristic, each tier list, Owned,
+ * Grade, Level, Stars, Unique, Ultimate and Acquisition
+ */
+std::vector<std::string> Headings(const Catalog &catalog);
+
+/**
+ * @brief Appends the text format of a hero, without a new line.
+ * @param &out Where to append it
+ * @param &catalog The catalog the hero is in
+ * @param &hero The hero
+ */
+void AppendText(std::string &out, const Catalog &catalog, const Hero &hero);
+
+/**
+ * @brief Writes a table that isn't of heroes, e.g. a summary of them: lined up
+ * for TABLE (and NAMES and TEXT), as CSV with the headings first, or as a JSON
+ * object for each row whose keys are the headings. Cells that are numbers are
+ * JSON numbers, and empty cells are null.
+ * @param &os Where to write the table
+ * @param &headings The headings of the columns
+ * @param &rows The rows, each with a cell for each heading
+ * @param format The format
+ */
+void WriteTable(std::ostream &os, const std::vector<std::string> &headings,
+                const std::vector<std::vector<std::string>> &rows,
+                Format format);
+
+/**
+ * @brief Writes heroes to a stream in a format. Heroes are written in the
+ * order they're added; a table is only written by Finish, as the width of
+ * each column depends on every hero.
+ */
+class Renderer {
+public:
+  /**
+   * @param &os Where to write the heroes
+   * @param &catalog The catalog the heroes are in
+   * @param format The format
+   */
+  Renderer(std::ostream &os, const Catalog &catalog, Format format);
+  Renderer(const Renderer &) = delete;
+  Renderer &operator=(const Renderer &) = delete;
+  /** @brief Finishes, if Finish wasn't called */
+  ~Renderer();
+
+  /** @brief Adds a hero, writing the buffer if it's full */
+  void Add(const Hero &hero);
+
+  /** @brief Adds the heroes with the indices in Catalog::list */
+  void Add(const std::vector<size_t> &rows);
+
+  /** @brief Writes everything added so far, except a table's rows */
+  void Flush();
+
+  /** @brief Writes the table, if the format is a table, then everything
+   * else, and flushes the stream. Heroes can be added again after it. */
+  void Finish();
+
+private:
+  std::ostream &os;
+  const Catalog &catalog;
+  Format format;
+  /** @brief What's waiting to be written */
+  std::string buffer;
+  /** @brief Whether the CSV headings have been written */
+  bool started;
+  /** @brief Where cells that aren't texts of the hero are formatted */
+  std::string scratch;
+  /** @brief The cells of the table, one after the other, and where each one
+   * ends */
+  std::string cells;
+  std::vector<size_t> ends;
+  /** @brief The widest cell of each column so far, in characters */
+  std::vector<size_t> widths;
+};
+} // namespace Render
@@ -0,0 +1,72 @@
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "Schema.h"
+
+namespace Schema {
+
+bool ParseInt(const std::string &str, int &value) {
+  size_t i{0};
+  bool negative = !str.empty() && (str[0] == '-' || str[0] == '+');
+  if (negative) {
+    negative = str[0] == '-';
+    i++;
+  }
+  if (i == str.size()) {
+    return false;
+  }
+
+  // accumulate as a negative number, since it has the larger range
+  int out{0};
+  for (; i < str.size(); i++) {
+    if (str[i] < '0' || str[i] > '9') {
+      return false;
+    }
+    int digit = str[i] - '0';
+    if (out < (INT_MIN + digit) / 10) {
+      return false;
+    }
+    out = out * 10 - digit;
+  }
+  if (!negative && out == INT_MIN) {
+    return false;
+  }
+  value = negative ? out : -out;
+  return true;
+}
+
+bool Text::Check(const std::string &field, std::string &expected) {
+  int value{};
+  if (ParseInt(field, value)) {
+    expected = "text, not a number";
+    return false;
+  }
+  if (field == "true" || field == "false") {
+    expected = "text, not a boolean";
+    return false;
+  }
+  return true;
+}
+
+bool Bool::Check(const std::string &field, std::string &expected) {
+  if (field == "true" || field == "false") {
+    return true;
+  }
+  expected = "a boolean (true or false)";
+  return false;
+}
+
+std::string Report(const std::string &source_name,
+                   const std::vector<std::string> &errors) {
+  std::string out = "Invalid data in " + source_name + ".";
+  for (size_t i{0}; i < errors.size() && i < MAX_REPORTED; i++) {
+    out += "\n" + errors[i];
+  }
+  if (errors.size() > MAX_REPORTED) {
+    out += "\n... and " + std::to_string(errors.size() - MAX_REPORTED) +
+           " more.";
+  }
+  return out;
+}
+} // namespace Schema
@@ -0,0 +1,88 @@
+/**
+ * @file Schema.h
+ * @brief Schema namespace describes the columns of the CSV data files, so
+ * that their records can be validated without exceptions.
+ */
+
+#pragma once
+
+#include <array>
+#include <climits>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Schema namespace describes the columns of the CSV data files, so
+ * that their records can be validated without exceptions. Each column type
+ * has a static function Check(field, &expected), which returns whether the
+ * field is valid, and otherwise sets expected to what it should be.
+ */
+namespace Schema {
+
+/**
+ * @brief Converts a whole string to an int, without throwing.
+ * @param &str The string, e.g. "-12"
+ * @param &value Set to the number, if the string is one
+ * @return whether the string is a number that fits in an int. Spaces and any
+ * other characters around it are not allowed.
+ */
+bool ParseInt(const std::string &str, int &value);
+
+/** @brief A column of text, which must not be a number or a boolean */
+struct Text {
+  static bool Check(const std::string &field, std::string &expected);
+};
+
+/** @brief A column of numbers between Min and Max, inclusive */
+template <int Min, int Max = INT_MAX> struct IntRange {
+  static bool Check(const std::string &field, std::string &expected);
+};
+
+/** @brief A column of booleans, i.e. true or false */
+struct Bool {
+  static bool Check(const std::string &field, std::string &expected);
+};
+
+/**
+ * @brief A column of one of a few options.
+ * @tparam Options A type with a static constexpr std::array of const char *
+ * named VALUES, which are the options
+ */
+template <typename Options> struct Enum {
+  static bool Check(const std::string &field, std::string &expected);
+};
+
+/**
+ * @brief The schema of a record, i.e. the type of each column in order.
+ */
+template <typename... Columns> struct Row {
+  /** @brief The number of columns */
+  static constexpr size_t SIZE{sizeof...(Columns)};
+
+  /**
+   * @brief Checks the size of a record and every one of its fields, in one
+   * pass and without throwing.
+   * @param &data The fields of the record
+   * @param &errors The messages for the invalid fields are added to it, e.g.
+   * item 4 "XR" should be one of R, SR, SSR, UR.
+   * @return whether the record is valid
+   */
+  static bool Validate(const std::vector<std::string> &data,
+                       std::vector<std::string> &errors);
+};
+
+/**
+ * @brief Makes one message from the errors in a data file.
+ * @param &source_name The name of the data file, e.g. data/heroes.csv
+ * @param &errors The errors, e.g. Line 3: item 9 "x" should be a number
+ * @return the message, with one error on each line. At most MAX_REPORTED
+ * errors are listed.
+ */
+std::string Report(const std::string &source_name,
+                   const std::vector<std::string> &errors);
+
+/** @brief The number of errors Report lists */
+static constexpr size_t MAX_REPORTED{20};
+} // namespace Schema
+
+#include "Schema.tpp"
@@ -0,0 +1,66 @@
+namespace Schema {
+
+template <int Min, int Max>
+bool IntRange<Min, Max>::Check(const std::string &field,
+                               std::string &expected) {
+  int value{};
+  if (ParseInt(field, value) && value >= Min && value <= Max) {
+    return true;
+  }
+  expected = Max == INT_MAX ? "a number of at least " + std::to_string(Min)
+                            : "a number between " + std::to_string(Min) +
+                                  " and " + std::to_string(Max);
+  return false;
+}
+
+template <typename Options>
+bool Enum<Options>::Check(const std::string &field, std::string &expected) {
+  for (const char *option : Options::VALUES) {
+    if (field == option) {
+      return true;
+    }
+  }
+  expected = "one of";
+  for (size_t i{0}; i < Options::VALUES.size(); i++) {
+    expected += (i == 0 ? " " : ", ") + std::string{Options::VALUES[i]};
+  }
+  return false;
+}
+
+namespace detail {
+/** @brief Checks the fields from index I onwards; the end of the recursion */
+template <size_t I>
+bool CheckColumns(const std::vector<std::string> &,
+                  std::vector<std::string> &) {
+  return true;
+}
+
+/** @brief Checks the field at index I with Column, then the rest */
+template <size_t I, typename Column, typename... Rest>
+bool CheckColumns(const std::vector<std::string> &data,
+                  std::vector<std::string> &errors) {
+  std::string expected{};
+  bool valid = Column::Check(data[I], expected);
+  if (!valid) {
+    errors.push_back("item " + std::to_string(I + 1) + " \"" + data[I] +
+                     "\" should be " + expected + ".");
+  }
+  // keep going, so every invalid field is reported
+  return CheckColumns<I + 1, Rest...>(data, errors) && valid;
+}
+} // namespace detail
+
+template <typename... Columns>
+constexpr size_t Row<Columns...>::SIZE;
+
+template <typename... Columns>
+bool Row<Columns...>::Validate(const std::vector<std::string> &data,
+                               std::vector<std::string> &errors) {
+  if (data.size() != SIZE) {
+    errors.push_back("there are " + std::to_string(data.size()) +
+                     " items instead of " + std::to_string(SIZE) + ".");
+    return false;
+  }
+  return detail::CheckColumns<0, Columns...>(data, errors);
+}
+} // namespace Schema
@@ -0,0 +1,565 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Hero.h"
+#include "Memory.h"
+#include "Search.h"
+#include "Stats.h"
+
+namespace Search {
+namespace {
+/** @brief The most other corrections of each word that are tried, after the
+ * best one */
+constexpr size_t MAX_ALTERNATIVES{3};
+
+/** @return the most typos corrected in a word of a length */
+size_t MaxDistance(size_t length) {
+  if (length < 3) {
+    return 0;
+  }
+  return length <= 4 ? 1 : MAX_DISTANCE;
+}
+
+/** @return whether a word is a number, which isn't corrected */
+bool IsNumber(const std::string &word) {
+  return std::all_of(word.begin(), word.end(), [](char ch) {
+    return std::isdigit(static_cast<unsigned char>(ch));
+  });
+}
+
+/** @return the words of folded text */
+std::vector<std::string> Split(const std::string &folded) {
+  std::vector<std::string> out{};
+  size_t start{0};
+  while (start < folded.size()) {
+    size_t end = folded.find(' ', start);
+    if (end == std::string::npos) {
+      end = folded.size();
+    }
+    out.push_back(folded.substr(start, end - start));
+    start = end + 1;
+  }
+  return out;
+}
+
+/** @brief Adds a word with every combination of up to distance letters
+ * deleted, including the word itself */
+void Deletes(const std::string &word, size_t distance,
+             std::unordered_set<std::string> &out) {
+  if (!out.insert(word).second || distance == 0) {
+    return;
+  }
+  for (size_t i{0}; i < word.size(); i++) {
+    Deletes(word.substr(0, i) + word.substr(i + 1), distance - 1, out);
+  }
+}
+
+/**
+ * @return the number of letters added, removed, changed or swapped with the
+ * next to make one word into another (the optimal string alignment distance),
+ * or max + 1 if it's more than max
+ */
+size_t Distance(const std::string &lhs, const std::string &rhs, size_t max) {
+  const size_t n = lhs.size();
+  const size_t m = rhs.size();
+  if ((n > m ? n - m : m - n) > max) {
+    return max + 1;
+  }
+  // three rows of the table of distances between prefixes
+  std::vector<size_t> before(m + 1), previous(m + 1), current(m + 1);
+  for (size_t j{0}; j <= m; j++) {
+    previous[j] = j;
+  }
+  for (size_t i{1}; i <= n; i++) {
+    current[0] = i;
+    size_t smallest = current[0];
+    for (size_t j{1}; j <= m; j++) {
+      size_t cost = lhs[i - 1] == rhs[j - 1] ? 0 : 1;
+      current[j] = std::min({previous[j] + 1, current[j - 1] + 1,
+                             previous[j - 1] + cost});
+      if (i > 1 && j > 1 && lhs[i - 1] == rhs[j - 2] &&
+          lhs[i - 2] == rhs[j - 1]) {
+        current[j] = std::min(current[j], before[j - 2] + 1);
+      }
+      smallest = std::min(smallest, current[j]);
+    }
+    if (smallest > max) {
+      return max + 1;
+    }
+    std::swap(before, previous);
+    std::swap(previous, current);
+  }
+  return std::min(previous[m], max + 1);
+}
+
+/** @return whether one folded text is before another */
+bool Less(const char *lhs, size_t lhs_length, const char *rhs,
+          size_t rhs_length) {
+  int compared = std::memcmp(lhs, rhs, std::min(lhs_length, rhs_length));
+  return compared != 0 ? compared < 0 : lhs_length < rhs_length;
+}
+} // namespace
+
+std::string Fold(const std::string &text) {
+  std::string out{};
+  out.reserve(text.size());
+  bool space{false};
+  for (char ch : text) {
+    unsigned char byte = static_cast<unsigned char>(ch);
+    if (std::isalnum(byte) || byte >= 0x80) {
+      if (space && !out.empty()) {
+        out += ' ';
+      }
+      space = false;
+      out += static_cast<char>(byte < 0x80 ? std::tolower(byte) : byte);
+    } else {
+      space = true;
+    }
+  }
+  return out;
+}
+
+std::string FieldName(Field field) {
+  switch (field) {
+  case HERO:
+    return "hero";
+  case NAME:
+    return "name";
+  case CHARACTER:
+    return "character";
+  }
+  return "";
+}
+
+Index::Index()
+    : folded{}, terms{}, postings{}, starts{}, best{}, words{}, deletes{} {}
+
+void Index::Build(const std::vector<Hero> &heroes) {
+  STATS_TIMER("Search/Build");
+  // the distinct texts of each field, and their heroes
+  struct Draft {
+    Text text;
+    Field field;
+    std::string folded;
+    std::vector<size_t> heroes;
+  };
+  std::vector<Draft> drafts{};
+  std::unordered_map<std::string, size_t> names{}, characters{};
+  for (const Hero &hero : heroes) {
+    // heroes.csv has each hero once
+    drafts.push_back({hero.hero, HERO, Fold(hero.hero), {hero.index}});
+    for (auto field : {std::make_pair(NAME, &hero.name),
+                       std::make_pair(CHARACTER, &hero.character)}) {
+      auto &seen = field.first == NAME ? names : characters;
+      auto found = seen.emplace(field.second->str(), drafts.size());
+      if (found.second) {
+        drafts.push_back({*field.second, field.first, Fold(*field.second),
+                          {hero.index}});
+      } else {
+        drafts[found.first->second].heroes.push_back(hero.index);
+      }
+    }
+  }
+  std::sort(drafts.begin(), drafts.end(),
+            [](const Draft &lhs, const Draft &rhs) {
+              if (lhs.field != rhs.field) {
+                return lhs.field < rhs.field;
+              }
+              return lhs.folded < rhs.folded;
+            });
+
+  folded.clear();
+  terms.clear();
+  postings.clear();
+  starts.clear();
+  best.clear();
+  words.clear();
+  deletes.clear();
+  std::unordered_map<std::string, uint32_t> word_terms{};
+  for (Draft &draft : drafts) {
+    if (folded.size() + draft.folded.size() >
+            std::numeric_limits<uint32_t>::max() ||
+        postings.size() + draft.heroes.size() >
+            std::numeric_limits<uint32_t>::max()) {
+      throw std::runtime_error("The heroes are too large to search.");
+    }
+    const uint32_t term = static_cast<uint32_t>(terms.size());
+    const uint32_t begin = static_cast<uint32_t>(folded.size());
+    terms.push_back({draft.text, draft.field, begin,
+                     static_cast<uint32_t>(draft.folded.size()),
+                     static_cast<uint32_t>(postings.size()),
+                     static_cast<uint32_t>(draft.heroes.size())});
+    folded += draft.folded;
+    postings.insert(postings.end(), draft.heroes.begin(), draft.heroes.end());
+    const Term &added = terms.back();
+    for (uint32_t i{0}; i < added.length; i++) {
+      if (i == 0 || draft.folded[i - 1] == ' ') {
+        const uint64_t rank = uint64_t{i != 0} << 63 |
+                              uint64_t{UINT32_MAX - added.count} << 31 |
+                              added.length;
+        starts.push_back(
+            {begin + i, term, added.length - i, added.field, rank});
+      }
+    }
+    for (const std::string &word : Split(draft.folded)) {
+      if (!IsNumber(word)) {
+        word_terms[word]++;
+      }
+    }
+  }
+  // starts of the same text are best first, so the starts of a whole term
+  // come before the starts of the same text in longer terms
+  std::sort(starts.begin(), starts.end(),
+            [this](const Start &lhs, const Start &rhs) {
+              if (Less(folded.data() + lhs.position, lhs.rest,
+                       folded.data() + rhs.position, rhs.rest)) {
+                return true;
+              }
+              if (Less(folded.data() + rhs.position, rhs.rest,
+                       folded.data() + lhs.position, lhs.rest)) {
+                return false;
+              }
+              return lhs.rank != rhs.rank ? lhs.rank < rhs.rank
+                                          : lhs.term < rhs.term;
+            });
+  best.resize(2 * starts.size());
+  for (size_t i{0}; i < starts.size(); i++) {
+    best[starts.size() + i] = static_cast<uint32_t>(i);
+  }
+  for (size_t i = starts.size(); i-- > 1;) {
+    best[i] = Better(best[2 * i + 1], best[2 * i]) ? best[2 * i + 1]
+                                                   : best[2 * i];
+  }
+
+  for (const auto &item : word_terms) {
+    words.push_back({item.first, item.second});
+  }
+  std::sort(words.begin(), words.end(), [](const Word &lhs, const Word &rhs) {
+    return lhs.word < rhs.word;
+  });
+  for (size_t i{0}; i < words.size(); i++) {
+    std::unordered_set<std::string> word_deletes{};
+    Deletes(words[i].word, MaxDistance(words[i].word.size()), word_deletes);
+    for (const std::string &deleted : word_deletes) {
+      deletes[deleted].push_back(static_cast<uint32_t>(i));
+    }
+  }
+}
+
+std::vector<Suggestion> Index::Complete(const std::string &prefix,
+                                        size_t count, unsigned fields) const {
+  STATS_TIMER("Search/Complete");
+  std::vector<Found> found{};
+  AddCompletions(Fold(prefix), 0, count, fields, found);
+  return Rank(found, count);
+}
+
+std::vector<Suggestion> Index::Suggest(const std::string &text, size_t count,
+                                       unsigned fields) const {
+  STATS_TIMER("Search/Suggest");
+  const std::string query = Fold(text);
+  std::vector<Found> found{};
+  AddCompletions(query, 0, count, fields, found);
+  if (found.size() >= count) {
+    return Rank(found, count);
+  }
+
+  // the corrections of each word; words that are already right, and the last
+  // word if it starts a word, have none
+  const std::vector<std::string> query_words = Split(query);
+  std::vector<std::vector<Correction>> corrections(query_words.size());
+  bool typos{false};
+  for (size_t i{0}; i < query_words.size(); i++) {
+    const std::string &word = query_words[i];
+    bool right = IsNumber(word) ||
+                 (i + 1 == query_words.size()
+                      ? StartsWord(word)
+                      : std::binary_search(words.begin(), words.end(),
+                                           Word{word, 0},
+                                           [](const Word &lhs,
+                                              const Word &rhs) {
+                                             return lhs.word < rhs.word;
+                                           }));
+    if (right) {
+      continue;
+    }
+    corrections[i] = Correct(word);
+    if (corrections[i].empty()) {
+      return Rank(found, count);
+    }
+    typos = true;
+  }
+  if (!typos) {
+    return Rank(found, count);
+  }
+
+  // the best correction of every word, then each other correction of one
+  // word, unless count texts with fewer typos have been found already
+  std::vector<size_t> choices(query_words.size(), 0);
+  auto complete = [this, &query_words, &corrections, &choices, count, fields,
+                   &found]() {
+    std::string corrected{};
+    size_t distance{0};
+    for (size_t i{0}; i < query_words.size(); i++) {
+      corrected += i == 0 ? "" : " ";
+      if (corrections[i].empty()) {
+        corrected += query_words[i];
+      } else {
+        const Correction &correction = corrections[i][choices[i]];
+        corrected += words[correction.word].word;
+        distance += correction.distance;
+      }
+    }
+    std::vector<uint32_t> closer{};
+    for (const Found &item : found) {
+      if (item.distance < distance) {
+        closer.push_back(item.term);
+      }
+    }
+    std::sort(closer.begin(), closer.end());
+    if (static_cast<size_t>(std::unique(closer.begin(), closer.end()) -
+                            closer.begin()) < count) {
+      AddCompletions(corrected, distance, count, fields, found);
+    }
+  };
+  complete();
+  for (size_t i{0}; i < query_words.size(); i++) {
+    for (size_t j{1}; j < corrections[i].size() && j <= MAX_ALTERNATIVES;
+         j++) {
+      choices[i] = j;
+      complete();
+    }
+    choices[i] = 0;
+  }
+  return Rank(found, count);
+}
+
+Span<size_t> Index::Find(const std::string &text, Field field) const {
+  const std::string query = Fold(text);
+  auto less = [this](const Term &term, const std::pair<Field, std::string>
+                                           &key) {
+    if (term.field != key.first) {
+      return term.field < key.first;
+    }
+    return Less(folded.data() + term.begin, term.length, key.second.data(),
+                key.second.size());
+  };
+  for (auto it = std::lower_bound(terms.begin(), terms.end(),
+                                  std::make_pair(field, query), less);
+       it != terms.end() && it->field == field && it->length == query.size() &&
+       folded.compare(it->begin, it->length, query) == 0;
+       it++) {
+    // different texts can be folded the same, e.g. King and king
+    if (it->text == text) {
+      return Span<size_t>{postings.data() + it->first, it->count};
+    }
+  }
+  return Span<size_t>{};
+}
+
+size_t Index::Bytes() const {
+  size_t bytes = Memory::Bytes(folded) + Memory::Bytes(terms) +
+                 Memory::Bytes(postings) + Memory::Bytes(starts) +
+                 Memory::Bytes(best) + Memory::Bytes(words);
+  for (const Word &word : words) {
+    bytes += Memory::Bytes(word.word);
+  }
+  // each entry of the map is a node with a pointer to the next
+  bytes += deletes.bucket_count() * sizeof(void *);
+  for (const auto &item : deletes) {
+    bytes += sizeof(item) + sizeof(void *) + Memory::Bytes(item.first) +
+             Memory::Bytes(item.second);
+  }
+  return bytes;
+}
+
+void Index::AddCompletions(const std::string &prefix, size_t distance,
+                           size_t count, unsigned fields,
+                           std::vector<Found> &found) const {
+  if (prefix.empty() || count == 0) {
+    return;
+  }
+  // the starts of the words the prefix starts are next to each other
+  const size_t size = prefix.size();
+  auto before = [this, size](const Start &start, const std::string &key) {
+    int compared = std::memcmp(folded.data() + start.position, key.data(),
+                               std::min<size_t>(start.rest, size));
+    return compared != 0 ? compared < 0 : start.rest < size;
+  };
+  auto after = [this, size](const std::string &key, const Start &start) {
+    return std::memcmp(folded.data() + start.position, key.data(),
+                       std::min<size_t>(start.rest, size)) > 0;
+  };
+  size_t first = static_cast<size_t>(
+      std::lower_bound(starts.begin(), starts.end(), prefix, before) -
+      starts.begin());
+  size_t last = static_cast<size_t>(
+      std::upper_bound(starts.begin() + static_cast<std::ptrdiff_t>(first),
+                       starts.end(), prefix, after) -
+      starts.begin());
+
+  // the terms the prefix is all of sort first
+  size_t scanned{0};
+  for (; first < last && starts[first].rest == size &&
+         starts[first].rank >> 63 == 0 && scanned < MAX_SCANNED;
+       first++, scanned++) {
+    const Start &start = starts[first];
+    if ((start.field & fields) != 0) {
+      found.push_back({distance, true, start.rank, start.term});
+    }
+  }
+
+  // then the rest, best first: the best start of a range is taken, and the
+  // ranges either side of it are searched next
+  using Range = std::pair<size_t, size_t>;
+  auto worse = [this](const std::pair<uint32_t, Range> &lhs,
+                      const std::pair<uint32_t, Range> &rhs) {
+    return Better(rhs.first, lhs.first);
+  };
+  std::priority_queue<std::pair<uint32_t, Range>,
+                      std::vector<std::pair<uint32_t, Range>>, decltype(worse)>
+      ranges{worse};
+  if (first < last) {
+    ranges.push({Best(first, last), {first, last}});
+  }
+  std::vector<uint32_t> added{};
+  for (; !ranges.empty() && added.size() < count && scanned < MAX_SCANNED;
+       scanned++) {
+    const uint32_t position = ranges.top().first;
+    const Range range = ranges.top().second;
+    ranges.pop();
+    const Start &start = starts[position];
+    if ((start.field & fields) != 0 &&
+        std::find(added.begin(), added.end(), start.term) == added.end()) {
+      added.push_back(start.term);
+      found.push_back({distance, false, start.rank, start.term});
+    }
+    if (range.first < position) {
+      ranges.push({Best(range.first, position), {range.first, position}});
+    }
+    if (position + 1 < range.second) {
+      ranges.push(
+          {Best(position + 1, range.second), {position + 1, range.second}});
+    }
+  }
+}
+
+bool Index::Better(uint32_t lhs, uint32_t rhs) const {
+  if (starts[lhs].rank != starts[rhs].rank) {
+    return starts[lhs].rank < starts[rhs].rank;
+  }
+  return starts[lhs].term < starts[rhs].term;
+}
+
+uint32_t Index::Best(size_t begin, size_t end) const {
+  uint32_t out = static_cast<uint32_t>(begin);
+  for (begin += starts.size(), end += starts.size(); begin < end;
+       begin /= 2, end /= 2) {
+    if (begin % 2 == 1) {
+      out = Better(best[begin], out) ? best[begin] : out;
+      begin++;
+    }
+    if (end % 2 == 1) {
+      end--;
+      out = Better(best[end], out) ? best[end] : out;
+    }
+  }
+  return out;
+}
+
+std::vector<Suggestion> Index::Rank(std::vector<Found> &found,
+                                    size_t count) const {
+  auto better = [](const Found &lhs, const Found &rhs) {
+    if (lhs.distance != rhs.distance) {
+      return lhs.distance < rhs.distance;
+    }
+    if (lhs.exact != rhs.exact) {
+      return lhs.exact;
+    }
+    if (lhs.rank != rhs.rank) {
+      return lhs.rank < rhs.rank;
+    }
+    return lhs.term < rhs.term;
+  };
+  // only the best are sorted; a term can be found more than once, so more are
+  // sorted until there are count different terms or none are left
+  std::vector<Suggestion> out{};
+  std::vector<uint32_t> chosen{};
+  size_t sorted{0};
+  for (size_t wanted = count; out.size() < count && sorted < found.size();
+       wanted *= 2) {
+    auto end = found.begin() +
+               static_cast<std::ptrdiff_t>(std::min(wanted, found.size()));
+    auto begin = found.begin() + static_cast<std::ptrdiff_t>(sorted);
+    std::nth_element(begin, end - 1, found.end(), better);
+    std::sort(begin, end, better);
+    for (auto it = begin; it != end && out.size() < count; it++) {
+      if (std::find(chosen.begin(), chosen.end(), it->term) != chosen.end()) {
+        continue;
+      }
+      chosen.push_back(it->term);
+      const Term &term = terms[it->term];
+      out.push_back({term.text, term.field, it->distance,
+                     Span<size_t>{postings.data() + term.first, term.count}});
+    }
+    sorted = static_cast<size_t>(end - found.begin());
+  }
+  return out;
+}
+
+std::vector<Index::Correction>
+Index::Correct(const std::string &word) const {
+  const size_t max = MaxDistance(word.size());
+  std::vector<Correction> out{};
+  if (max == 0) {
+    return out;
+  }
+  std::unordered_set<std::string> word_deletes{};
+  Deletes(word, max, word_deletes);
+  std::unordered_set<uint32_t> seen{};
+  for (const std::string &deleted : word_deletes) {
+    auto found = deletes.find(deleted);
+    if (found == deletes.end()) {
+      continue;
+    }
+    for (uint32_t candidate : found->second) {
+      if (!seen.insert(candidate).second) {
+        continue;
+      }
+      // words sharing a deletion can still be further apart, e.g. ab and ba
+      // both become a
+      size_t distance = Distance(word, words[candidate].word, max);
+      if (distance <= max) {
+        out.push_back({candidate, distance});
+      }
+    }
+  }
+  std::sort(out.begin(), out.end(),
+            [this](const Correction &lhs, const Correction &rhs) {
+              if (lhs.distance != rhs.distance) {
+                return lhs.distance < rhs.distance;
+              }
+              if (words[lhs.word].terms != words[rhs.word].terms) {
+                return words[lhs.word].terms > words[rhs.word].terms;
+              }
+              return lhs.word < rhs.word;
+            });
+  return out;
+}
+
+bool Index::StartsWord(const std::string &word) const {
+  auto it = std::lower_bound(
+      words.begin(), words.end(), word,
+      [](const Word &lhs, const std::string &rhs) { return lhs.word < rhs; });
+  return it != words.end() && it->word.compare(0, word.size(), word) == 0;
+}
+} // namespace Search
@@ -0,0 +1,209 @@
+/**
+ * @file Search.h
+ * @brief Declares Search::Index, which finds heroes, names and characters
+ * from part of their text, even with typos.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+
+struct Hero;
+
+/**
+ * @brief Search namespace finds heroes (e.g. [Boar Hat] Tavern Master
+ * Meliodas), names (Tavern Master Meliodas) and characters (Meliodas) from
+ * text that starts any of their words, or that has a few typos. Text is
+ * compared folded: in lowercase, with punctuation as spaces.
+ */
+namespace Search {
+
+/** @brief The fields of a hero that are searched; they can be combined with
+ * | to search several */
+enum Field : unsigned { HERO = 1, NAME = 2, CHARACTER = 4 };
+
+/** @brief Every field */
+static constexpr unsigned ALL_FIELDS{HERO | NAME | CHARACTER};
+
+/** @brief The most typos (letters added, removed, changed or swapped) in a
+ * word that are corrected. Words of up to 4 letters only get 1. */
+static constexpr size_t MAX_DISTANCE{2};
+
+/** @brief The most places a prefix is found at that are checked, best first.
+ * Only searches of fields few texts have check more than a few. */
+static constexpr size_t MAX_SCANNED{4096};
+
+/** @brief A text found by a search */
+struct Suggestion {
+  /** @brief the text as it is in the hero, e.g. Meliodas */
+  Text text;
+  Field field;
+  /** @brief the number of typos corrected to find it */
+  size_t distance;
+  /** @brief the indices in Catalog::list of the heroes with the text, in
+   * order. Only valid as long as the index. */
+  Span<size_t> heroes;
+};
+
+/**
+ * @param &text A text
+ * @return the text folded: ASCII letters in lowercase, and anything else
+ * except numbers and non-ASCII characters replaced by a space, with one space
+ * between words, e.g. [Boar Hat] Tavern becomes boar hat tavern
+ */
+std::string Fold(const std::string &text);
+
+/** @return the name of a field, e.g. character */
+std::string FieldName(Field field);
+
+/**
+ * @brief An index of the hero, name and character of every hero. Prefixes are
+ * completed with a sorted list of every place a word starts in the folded
+ * texts, so the completions of a prefix are next to each other, as in a trie.
+ * Typos are corrected with an index of every word with up to MAX_DISTANCE
+ * letters deleted, so a misspelt word is found from the words that share a
+ * deletion with it (as SymSpell does). Numbers aren't corrected.
+ */
+class Index {
+public:
+  /** @brief An empty index */
+  Index();
+
+  /**
+   * @brief Indexes heroes, replacing anything indexed before. The index
+   * refers to the texts of the heroes, so it's only valid as long as their
+   * arena.
+   * @param &heroes The heroes, e.g. Catalog::list
+   * @throw std::runtime_error if the texts are over 4 GB in total
+   */
+  void Build(const std::vector<Hero> &heroes);
+
+  /**
+   * @brief Finds the texts with a word starting with a prefix, e.g. mast
+   * finds Tavern Master Meliodas. They're ranked: exact matches first, then
+   * texts the prefix starts, then texts more heroes have, then shorter texts.
+   * @param &prefix The prefix; it's folded
+   * @param count The most texts to find
+   * @param fields The fields to search
+   * @return the texts, best first
+   */
+  std::vector<Suggestion> Complete(const std::string &prefix, size_t count,
+                                   unsigned fields = ALL_FIELDS) const;
+
+  /**
+   * @brief Completes text like Complete, and if that finds fewer than count
+   * texts, corrects typos in its words and completes the corrected text too.
+   * Texts with fewer typos are ranked first.
+   * @param &text The text; it's folded
+   * @param count The most texts to find
+   * @param fields The fields to search
+   * @return the texts, best first
+   */
+  std::vector<Suggestion> Suggest(const std::string &text, size_t count,
+                                  unsigned fields = ALL_FIELDS) const;
+
+  /**
+   * @param &text A text
+   * @param field A field
+   * @return the heroes with exactly the text in the field, e.g. every hero
+   * whose character is Meliodas, or an empty span
+   */
+  Span<size_t> Find(const std::string &text, Field field) const;
+
+  /** @return the memory the index uses, in bytes */
+  size_t Bytes() const;
+
+private:
+  /** @brief A distinct text of a field */
+  struct Term {
+    Text text;
+    Field field;
+    /** @brief where its folded text is in folded */
+    uint32_t begin;
+    uint32_t length;
+    /** @brief where its heroes are in postings */
+    uint32_t first;
+    uint32_t count;
+  };
+
+  /** @brief A word of the folded texts and the number of terms with it */
+  struct Word {
+    std::string word;
+    uint32_t terms;
+  };
+
+  /** @brief A place a word starts in folded, with what's needed to rank
+   * its term, so completing a prefix only reads starts */
+  struct Start {
+    uint32_t position;
+    uint32_t term;
+    /** @brief the length of the folded text from position to the end of the
+     * term */
+    uint32_t rest;
+    Field field;
+    /** @brief how good a match it is when it isn't exact: whether it's the
+     * start of the term, then how many heroes have the term, then how long
+     * the term is. Lower is better. */
+    uint64_t rank;
+  };
+
+  /** @brief A term found by a search, and how good a match it is */
+  struct Found {
+    size_t distance;
+    /** @brief whether the text is the whole term */
+    bool exact;
+    /** @see Start::rank */
+    uint64_t rank;
+    uint32_t term;
+  };
+
+  /** @brief A correction of a word and its number of typos */
+  struct Correction {
+    uint32_t word;
+    size_t distance;
+  };
+
+  /** @brief Adds the best count terms completing a folded prefix, which has
+   * a number of typos, to found */
+  void AddCompletions(const std::string &prefix, size_t distance,
+                      size_t count, unsigned fields,
+                      std::vector<Found> &found) const;
+
+  /** @return whether a start is a better match than another */
+  bool Better(uint32_t lhs, uint32_t rhs) const;
+
+  /** @return the best start in [begin, end) of starts */
+  uint32_t Best(size_t begin, size_t end) const;
+
+  /** @return the best count terms found, each once, best first */
+  std::vector<Suggestion> Rank(std::vector<Found> &found, size_t count) const;
+
+  /** @return the corrections of a word, fewest typos and most used first */
+  std::vector<Correction> Correct(const std::string &word) const;
+
+  /** @return whether a word starts any word in the index */
+  bool StartsWord(const std::string &word) const;
+
+  /** @brief the folded texts of the terms, one after the other */
+  std::string folded;
+  std::vector<Term> terms;
+  /** @brief the heroes of each term, one term after the other */
+  std::vector<size_t> postings;
+  /** @brief every word start in folded, sorted by the folded text from
+   * there to the end of the term */
+  std::vector<Start> starts;
+  /** @brief a segment tree of the best start in ranges of starts: the best of
+   * best[2i] and best[2i + 1] is best[i], and best[starts.size() + i] is i */
+  std::vector<uint32_t> best;
+  /** @brief the distinct words, sorted, except numbers */
+  std::vector<Word> words;
+  /** @brief the words with each deletion of up to MAX_DISTANCE letters */
+  std::unordered_map<std::string, std::vector<uint32_t>> deletes;
+};
+} // namespace Search
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Stats.h"
+
+namespace Stats {
+namespace {
+/** @brief Protects metrics */
+std::mutex mutex{};
+
+/** @brief Every metric by name, so they're sorted for reports */
+std::map<std::string, std::unique_ptr<Metric>> metrics{};
+
+std::atomic<bool> enabled{false};
+
+/** @return the value at a percentile of some sorted durations, or 0 */
+uint64_t Percentile(const std::vector<uint64_t> &sorted, size_t percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[(sorted.size() - 1) * percentile / 100];
+}
+
+/** @brief A copy of a metric, for reports */
+struct Snapshot {
+  std::string name;
+  bool timer;
+  uint64_t count;
+  uint64_t total;
+  uint64_t p50;
+  uint64_t p99;
+};
+
+/** @return copies of every metric that has run, sorted by name */
+std::vector<Snapshot> TakeSnapshots() {
+  std::vector<Snapshot> out{};
+  std::lock_guard<std::mutex> lock{mutex};
+  for (const auto &item : metrics) {
+    Metric &metric = *item.second;
+    Snapshot snapshot{metric.name, metric.timer, metric.count.load(),
+                      metric.total.load(), 0, 0};
+    if (snapshot.count == 0) {
+      continue;
+    }
+    if (metric.timer) {
+      std::vector<uint64_t> samples{};
+      {
+        std::lock_guard<std::mutex> samples_lock{metric.mutex};
+        samples = metric.samples;
+      }
+      std::sort(samples.begin(), samples.end());
+      snapshot.p50 = Percentile(samples, 50);
+      snapshot.p99 = Percentile(samples, 99);
+    }
+    out.push_back(snapshot);
+  }
+  return out;
+}
+} // namespace
+
+Metric::Metric(const std::string &name, bool timer)
+    : name{name}, timer{timer}, count{0}, total{0}, mutex{}, samples{} {}
+
+void Metric::Record(uint64_t nanoseconds) {
+  uint64_t index = count.fetch_add(1, std::memory_order_relaxed);
+  total.fetch_add(nanoseconds, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock{mutex};
+  if (samples.size() < MAX_SAMPLES) {
+    samples.push_back(nanoseconds);
+  } else {
+    samples[index % MAX_SAMPLES] = nanoseconds;
+  }
+}
+
+Metric &Get(const std::string &name, bool timer) {
+  std::lock_guard<std::mutex> lock{mutex};
+  std::unique_ptr<Metric> &metric = metrics[name];
+  if (!metric) {
+    metric.reset(new Metric{name, timer});
+  }
+  return *metric;
+}
+
+bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+void Enable(bool value) { enabled = value; }
+
+void Reset() {
+  std::lock_guard<std::mutex> lock{mutex};
+  for (auto &item : metrics) {
+    Metric &metric = *item.second;
+    metric.count = 0;
+    metric.total = 0;
+    std::lock_guard<std::mutex> samples_lock{metric.mutex};
+    metric.samples.clear();
+  }
+}
+
+void Print(std::ostream &os) {
+#ifndef SDSGC_STATS
+  os << "Stats weren't compiled in. Build with the CMake option STATS."
+     << std::endl;
+  return;
+#endif
+  auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+  os << std::left << std::setw(40) << "timer" << std::right << std::setw(10)
+     << "calls" << std::setw(12) << "total (ms)" << std::setw(12)
+     << "p50 (ms)" << std::setw(12) << "p99 (ms)" << std::endl;
+  std::vector<Snapshot> snapshots = TakeSnapshots();
+  for (const Snapshot &snapshot : snapshots) {
+    if (snapshot.timer) {
+      os << std::left << std::setw(40) << snapshot.name << std::right
+         << std::setw(10) << snapshot.count << std::fixed
+         << std::setprecision(3) << std::setw(12) << ms(snapshot.total)
+         << std::setw(12) << ms(snapshot.p50) << std::setw(12)
+         << ms(snapshot.p99) << std::endl;
+    }
+  }
+  os << std::endl
+     << std::left << std::setw(40) << "counter" << std::right << std::setw(10)
+     << "calls" << std::setw(16) << "total" << std::endl;
+  for (const Snapshot &snapshot : snapshots) {
+    if (!snapshot.timer) {
+      os << std::left << std::setw(40) << snapshot.name << std::right
+         << std::setw(10) << snapshot.count << std::setw(16) << snapshot.total
+         << std::endl;
+    }
+  }
+}
+
+std::string ToJSON() {
+#ifdef SDSGC_STATS
+  std::string out{"{\"compiled\": true, \"metrics\": ["};
+#else
+  std::string out{"{\"compiled\": false, \"metrics\": ["};
+#endif
+  std::vector<Snapshot> snapshots = TakeSnapshots();
+  for (size_t i{0}; i < snapshots.size(); i++) {
+    const Snapshot &snapshot = snapshots[i];
+    // metric names are chosen in the code, and have no quotes or backslashes
+    out += std::string{i == 0 ? "" : ", "} + "{\"name\": \"" + snapshot.name +
+           "\", ";
+    if (snapshot.timer) {
+      out += "\"type\": \"timer\", \"count\": " +
+             std::to_string(snapshot.count) +
+             ", \"total_ns\": " + std::to_string(snapshot.total) +
+             ", \"p50_ns\": " + std::to_string(snapshot.p50) +
+             ", \"p99_ns\": " + std::to_string(snapshot.p99) + "}";
+    } else {
+      out += "\"type\": \"counter\", \"count\": " +
+             std::to_string(snapshot.count) +
+             ", \"total\": " + std::to_string(snapshot.total) + "}";
+    }
+  }
+  return out + "]}";
+}
+} // namespace Stats
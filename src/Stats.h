@@ -0,0 +1,134 @@
+/**
+ * @file Stats.h
+ * @brief Stats namespace counts and times what the program does, e.g. each
+ * phase of Heroes::MakeHeroes, so that slow parts can be found.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Stats namespace counts and times what the program does. Use the
+ * macros STATS_TIMER and STATS_COUNT, which do nothing unless the program is
+ * built with SDSGC_STATS defined (the CMake option STATS). Even then, timers
+ * only read the clock while stats are enabled, e.g. with --stats.
+ */
+namespace Stats {
+
+/** @brief The most durations kept for the percentiles of each timer */
+static constexpr size_t MAX_SAMPLES{4096};
+
+/**
+ * @brief A named counter, or a named timer: how many times it ran and for how
+ * long in total, with some of the durations for percentiles.
+ */
+struct Metric {
+  explicit Metric(const std::string &name, bool timer);
+
+  std::string name;
+  bool timer;
+  std::atomic<uint64_t> count;
+  /** @brief Nanoseconds for timers, or the amount counted for counters */
+  std::atomic<uint64_t> total;
+
+  /** @brief Protects samples */
+  std::mutex mutex;
+  /** @brief Durations in nanoseconds. When there are MAX_SAMPLES, new ones
+   * replace old ones in turn. */
+  std::vector<uint64_t> samples;
+
+  /** @brief Records one duration */
+  void Record(uint64_t nanoseconds);
+};
+
+/**
+ * @brief Finds a metric, making it if it doesn't exist yet. The macros call
+ * this once for each place they're used, so it can be slow.
+ * @param &name The name, e.g. MakeHeroes/read heroes.csv
+ * @param timer Whether it's a timer, not a counter
+ * @return the metric, which exists until the program ends
+ */
+Metric &Get(const std::string &name, bool timer);
+
+/** @brief Whether timers read the clock */
+bool Enabled();
+
+/** @brief Starts or stops timers reading the clock */
+void Enable(bool enabled);
+
+/** @brief Sets every metric back to 0 */
+void Reset();
+
+/** @brief Prints every metric that has run, as a table sorted by name */
+void Print(std::ostream &os);
+
+/**
+ * @return every metric that has run as a JSON document: {"compiled": true,
+ * "metrics": [{"name": ..., "type": "timer", "count": ..., "total_ns": ...,
+ * "p50_ns": ..., "p99_ns": ...}, {"name": ..., "type": "counter", "count":
+ * ..., "total": ...}, ...]}
+ */
+std::string ToJSON();
+
+/**
+ * @brief Times the scope it's in, if stats are enabled.
+ */
+class Timer {
+public:
+  explicit Timer(Metric &metric)
+      : metric{metric}, running{Enabled()}, start{} {
+    if (running) {
+      start = std::chrono::steady_clock::now();
+    }
+  }
+  Timer(const Timer &) = delete;
+  Timer &operator=(const Timer &) = delete;
+  ~Timer() {
+    if (running) {
+      metric.Record(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count()));
+    }
+  }
+
+private:
+  Metric &metric;
+  bool running;
+  std::chrono::steady_clock::time_point start;
+};
+} // namespace Stats
+
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+
+#ifdef SDSGC_STATS
+/** @brief Times the rest of the scope as the timer name */
+#define STATS_TIMER(name)                                                      \
+  static Stats::Metric &STATS_CONCAT(stats_metric_, __LINE__) =                \
+      Stats::Get(name, true);                                                  \
+  Stats::Timer STATS_CONCAT(stats_timer_, __LINE__) {                          \
+    STATS_CONCAT(stats_metric_, __LINE__)                                      \
+  }
+/** @brief Adds amount to the counter name */
+#define STATS_COUNT(name, amount)                                              \
+  do {                                                                         \
+    static Stats::Metric &stats_metric_ = Stats::Get(name, false);             \
+    stats_metric_.count.fetch_add(1, std::memory_order_relaxed);               \
+    stats_metric_.total.fetch_add(static_cast<uint64_t>(amount),              \
+                                  std::memory_order_relaxed);                  \
+  } while (false)
+#else
+#define STATS_TIMER(name)
+#define STATS_COUNT(name, amount)                                              \
+  do {                                                                         \
+    (void)sizeof(amount);                                                      \
+  } while (false)
+#endif
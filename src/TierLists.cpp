@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Hero.h"
+#include "Heroes.h"
+#include "Memory.h"
+#include "TierLists.h"
+
+namespace TierLists {
+
+constexpr size_t TierList::CHECKPOINT_INTERVAL;
+
+TierList::TierList(const std::string &name, size_t size)
+    : name{name}, latest(size, 0), revisions{}, checkpoints{} {}
+
+void TierList::Commit(size_t revision, const std::vector<Change> &changes) {
+  if (!revisions.empty() && revision <= revisions.back().revision) {
+    throw std::invalid_argument("Revision " + std::to_string(revision) +
+                                " of tier list " + name +
+                                " is older than its last revision.");
+  }
+
+  // check every change before applying any, so an invalid revision leaves
+  // the list as it was
+  for (const Change &change : changes) {
+    if (change.first >= latest.size()) {
+      throw std::invalid_argument("Invalid hero index in tier list " + name);
+    }
+  }
+  for (const Change &change : changes) {
+    latest[change.first] = change.second;
+  }
+
+  // store the whole list every CHECKPOINT_INTERVAL revisions, otherwise only
+  // the changes
+  if (revisions.size() % CHECKPOINT_INTERVAL == 0) {
+    revisions.push_back({revision, {}, checkpoints.size()});
+    checkpoints.push_back(latest);
+  } else {
+    revisions.push_back({revision, changes, checkpoints.size()});
+  }
+}
+
+std::vector<int> TierList::AsOf(size_t revision) const {
+  // find the last revision at or before the one asked for
+  auto last = std::upper_bound(
+      revisions.begin(), revisions.end(), revision,
+      [](size_t value, const Revision &item) { return value < item.revision; });
+  if (last == revisions.begin()) {
+    return std::vector<int>(latest.size(), 0);
+  }
+
+  // start from the checkpoint before it, then replay the changes after that
+  size_t end = static_cast<size_t>(last - revisions.begin());
+  size_t start = (end - 1) - ((end - 1) % CHECKPOINT_INTERVAL);
+  std::vector<int> out = checkpoints[revisions[start].checkpoint];
+  for (size_t i{start + 1}; i < end; i++) {
+    for (const Change &change : revisions[i].changes) {
+      out[change.first] = change.second;
+    }
+  }
+  return out;
+}
+
+size_t TierList::Bytes() const {
+  size_t bytes = Memory::Bytes(name) + Memory::Bytes(latest) +
+                 Memory::Bytes(revisions) + Memory::Bytes(checkpoints);
+  for (const Revision &item : revisions) {
+    bytes += Memory::Bytes(item.changes);
+  }
+  for (const std::vector<int> &checkpoint : checkpoints) {
+    bytes += Memory::Bytes(checkpoint);
+  }
+  return bytes;
+}
+
+size_t Register(Heroes::Dataset &dataset, const std::string &name) {
+  for (const TierList &list : dataset.tier_lists) {
+    if (list.Name() == name) {
+      throw std::invalid_argument("The tier list " + name +
+                                  " already exists.");
+    }
+  }
+  dataset.tier_lists.emplace_back(name, dataset.list.size());
+  return dataset.tier_lists.size() - 1;
+}
+
+size_t TryFind(const std::vector<TierList> &lists, const std::string &name) {
+  for (size_t i{0}; i < lists.size(); i++) {
+    if (lists[i].Name() == name) {
+      return i;
+    }
+  }
+  return NOT_FOUND;
+}
+
+size_t Find(const std::vector<TierList> &lists, const std::string &name) {
+  size_t index = TryFind(lists, name);
+  if (index == NOT_FOUND) {
+    throw std::invalid_argument("There is no tier list called " + name + ".");
+  }
+  return index;
+}
+
+void Commit(Heroes::Dataset &dataset, size_t list, size_t revision,
+            const std::vector<Change> &changes) {
+  TierList &tier_list = dataset.tier_lists.at(list);
+  tier_list.Commit(revision, changes);
+  dataset.revision = std::max(dataset.revision, revision);
+}
+
+void Seed(Heroes::Dataset &dataset,
+          const std::vector<std::array<std::string, Hero::INFORMATION_COUNT>>
+              &heroes) {
+  // the tier columns are the last ones of heroes.csv, in CSV_LISTS order
+  const size_t first = Hero::INFORMATION_COUNT - CSV_LISTS.size();
+  for (size_t i{0}; i < CSV_LISTS.size(); i++) {
+    dataset.tier_lists.emplace_back(CSV_LISTS[i], heroes.size());
+    std::vector<Change> changes(heroes.size());
+    for (size_t j{0}; j < heroes.size(); j++) {
+      changes[j] = {j, std::stoi(heroes[j][first + i])};
+    }
+    dataset.tier_lists.back().Commit(0, changes);
+  }
+}
+} // namespace TierLists
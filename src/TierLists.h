@@ -0,0 +1,150 @@
+/**
+ * @file TierLists.h
+ * @brief TierLists namespace contains the named tier lists and the history of
+ * their revisions.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Hero.h"
+
+namespace Heroes {
+struct Dataset;
+} // namespace Heroes
+
+/**
+ * @brief TierLists namespace contains the named tier lists and the history of
+ * their revisions.
+ */
+namespace TierLists {
+
+/** @brief The names of the tier lists in the heroes.csv tier columns, in
+ * column order. They are registered first, at revision 0. */
+constexpr std::array<const char *, 4> CSV_LISTS{
+    {"Amazing's PVP", "Amazing's PVE", "Nagato's PVP", "Nagato's PVE"}};
+
+/** @brief A change to a tier list: {Hero index, tier} */
+using Change = std::pair<size_t, int>;
+
+/**
+ * @brief A named tier list and every revision of it. Each revision is stored
+ * as the changes since the previous revision, and every CHECKPOINT_INTERVAL
+ * revisions the whole list is stored, so reconstructing a revision never
+ * replays more than CHECKPOINT_INTERVAL revisions.
+ */
+class TierList {
+public:
+  /** @brief The number of revisions between full copies of the list */
+  static constexpr size_t CHECKPOINT_INTERVAL{8};
+
+  /**
+   * @param &name The name of the tier list, e.g. Amazing's PVP
+   * @param size The number of heroes
+   */
+  TierList(const std::string &name, size_t size);
+
+  /** @brief The name of the tier list */
+  const std::string &Name() const { return name; }
+
+  /** @brief The latest tiers, indexed by Hero::index. 0 means unranked. */
+  const std::vector<int> &Latest() const { return latest; }
+
+  /** @brief The number of revisions of this list */
+  size_t Revisions() const { return revisions.size(); }
+
+  /**
+   * @brief Adds a revision to the list.
+   * @param revision The revision number. It must be greater than the list's
+   * last revision number.
+   * @param &changes The tiers that changed in this revision
+   * @throw std::invalid_argument if revision isn't the newest revision, or a
+   * change has a hero index that is out of range; the list is left unchanged
+   */
+  void Commit(size_t revision, const std::vector<Change> &changes);
+
+  /**
+   * @brief Reconstructs the list as it was at a revision.
+   * @param revision Any revision number
+   * @return the tiers, indexed by Hero::index. Every hero is unranked (0) if
+   * the list didn't exist yet.
+   */
+  std::vector<int> AsOf(size_t revision) const;
+
+  /** @brief An estimate of the memory the list allocated, in bytes */
+  size_t Bytes() const;
+
+private:
+  /** @brief A revision; either a checkpoint or the changes since the last
+   * revision */
+  struct Revision {
+    size_t revision;
+    std::vector<Change> changes;
+    /** @brief The index in checkpoints, or checkpoints.size() if this
+     * revision isn't a checkpoint */
+    size_t checkpoint;
+  };
+
+  std::string name;
+  std::vector<int> latest;
+  std::vector<Revision> revisions;
+  std::vector<std::vector<int>> checkpoints;
+};
+
+/**
+ * @brief Registers a new, empty tier list in a dataset. Every hero is unranked
+ * in it until a revision is committed.
+ * @param &dataset The dataset
+ * @param &name The name of the tier list
+ * @return the index of the list in the dataset's tier lists
+ * @throw std::invalid_argument if a list with that name already exists
+ */
+size_t Register(Heroes::Dataset &dataset, const std::string &name);
+
+/** @brief What TryFind returns when there is no list with the name */
+constexpr size_t NOT_FOUND{static_cast<size_t>(-1)};
+
+/**
+ * @param &lists The tier lists, e.g. Catalog::tier_lists
+ * @param &name The name of a tier list
+ * @return the index of the list in lists, or NOT_FOUND if there is no list
+ * with that name
+ */
+size_t TryFind(const std::vector<TierList> &lists, const std::string &name);
+
+/**
+ * @param &lists The tier lists, e.g. Catalog::tier_lists
+ * @param &name The name of a tier list
+ * @return the index of the list in lists
+ * @throw std::invalid_argument if there is no list with that name
+ */
+size_t Find(const std::vector<TierList> &lists, const std::string &name);
+
+/**
+ * @brief Adds a revision to a tier list in a dataset, and updates the
+ * dataset's newest revision.
+ * @param &dataset The dataset
+ * @param list The index of the tier list
+ * @param revision The revision number
+ * @param &changes The tiers that changed in this revision
+ * @see TierList::Commit
+ */
+void Commit(Heroes::Dataset &dataset, size_t list, size_t revision,
+            const std::vector<Change> &changes);
+
+/**
+ * @brief Registers the tier lists in heroes.csv (CSV_LISTS) at revision 0 in
+ * a dataset, using the tier columns of heroes.csv.
+ * @param &dataset The dataset
+ * @param &heroes The lines of heroes.csv, in the order of the dataset's
+ * heroes, already validated
+ */
+void Seed(Heroes::Dataset &dataset,
+          const std::vector<std::array<std::string, Hero::INFORMATION_COUNT>>
+              &heroes);
+} // namespace TierLists
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Memory.h"
+#include "Stats.h"
+#include "Trigrams.h"
+
+namespace Trigrams {
+namespace {
+/** @brief The number of bytes in a trigram */
+constexpr size_t LENGTH{3};
+
+/** @brief Adds the distinct trigrams of a text to out, which is cleared */
+void Keys(const char *text, size_t size, std::vector<uint32_t> &out) {
+  auto byte = [text](size_t i) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(text[i]));
+  };
+  out.clear();
+  for (size_t i{0}; i + LENGTH <= size; i++) {
+    out.push_back(byte(i) << 16 | byte(i + 1) << 8 | byte(i + 2));
+  }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+/**
+ * @brief Keeps the numbers of a sorted list that are in another sorted list,
+ * which should be the longer one. Each number is found by galloping from the
+ * last one found, so a short list costs little however long the other is.
+ */
+void Intersect(std::vector<uint32_t> &list, const uint32_t *other,
+               size_t size) {
+  size_t kept{0};
+  size_t low{0};
+  for (uint32_t value : list) {
+    // double the step until it passes the value, then search the last step
+    size_t step{1};
+    size_t high = low;
+    while (high < size && other[high] < value) {
+      low = high + 1;
+      high += step;
+      step *= 2;
+    }
+    low = static_cast<size_t>(
+        std::lower_bound(other + low, other + std::min(high, size), value) -
+        other);
+    if (low == size) {
+      break;
+    }
+    if (other[low] == value) {
+      list[kept++] = value;
+    }
+  }
+  list.resize(kept);
+}
+} // namespace
+
+std::string Lower(const std::string &text) {
+  std::string out{text};
+  for (char &ch : out) {
+    unsigned char byte = static_cast<unsigned char>(ch);
+    if (byte < 0x80) {
+      ch = static_cast<char>(std::tolower(byte));
+    }
+  }
+  return out;
+}
+
+Index::Index() : text{}, ends{}, keys{}, offsets{}, postings{} {}
+
+void Index::Build(const std::vector<Text> &documents) {
+  STATS_TIMER("Trigrams/Build");
+  text.clear();
+  ends.clear();
+  keys.clear();
+  offsets.clear();
+  postings.clear();
+  size_t size{0};
+  for (const Text &document : documents) {
+    size += document.size();
+  }
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("The texts are too large to index.");
+  }
+  text.reserve(size);
+  ends.reserve(documents.size());
+  for (const Text &document : documents) {
+    text += Lower(document.str());
+    ends.push_back(static_cast<uint32_t>(text.size()));
+  }
+
+  // count the documents with each trigram, then put each document in the
+  // postings of its trigrams, so each list is in order without sorting
+  std::unordered_map<uint32_t, uint32_t> counts{};
+  std::vector<uint32_t> document_keys{};
+  for (uint32_t i{0}; i < ends.size(); i++) {
+    uint32_t begin = i == 0 ? 0 : ends[i - 1];
+    Keys(text.data() + begin, ends[i] - begin, document_keys);
+    for (uint32_t key : document_keys) {
+      counts[key]++;
+    }
+  }
+  keys.reserve(counts.size());
+  for (const auto &count : counts) {
+    keys.push_back(count.first);
+  }
+  std::sort(keys.begin(), keys.end());
+  offsets.resize(keys.size() + 1, 0);
+  for (size_t i{0}; i < keys.size(); i++) {
+    uint32_t &count = counts[keys[i]];
+    offsets[i + 1] = offsets[i] + count;
+    // from here, where the next document with the trigram goes
+    count = offsets[i];
+  }
+  postings.resize(offsets.back());
+  for (uint32_t i{0}; i < ends.size(); i++) {
+    uint32_t begin = i == 0 ? 0 : ends[i - 1];
+    Keys(text.data() + begin, ends[i] - begin, document_keys);
+    for (uint32_t key : document_keys) {
+      postings[counts[key]++] = i;
+    }
+  }
+}
+
+std::vector<uint32_t>
+Index::Find(const std::vector<std::string> &terms) const {
+  STATS_TIMER("Trigrams/Find");
+  std::vector<std::string> lower{};
+  for (const std::string &term : terms) {
+    lower.push_back(Lower(term));
+  }
+
+  // the postings of every trigram of every term, shortest first
+  std::vector<std::pair<const uint32_t *, size_t>> lists{};
+  std::vector<uint32_t> term_keys{};
+  for (const std::string &term : lower) {
+    Keys(term.data(), term.size(), term_keys);
+    for (uint32_t key : term_keys) {
+      auto found = std::lower_bound(keys.begin(), keys.end(), key);
+      if (found == keys.end() || *found != key) {
+        return {};
+      }
+      size_t i = static_cast<size_t>(found - keys.begin());
+      lists.emplace_back(postings.data() + offsets[i],
+                         offsets[i + 1] - offsets[i]);
+    }
+  }
+  std::sort(lists.begin(), lists.end(),
+            [](const std::pair<const uint32_t *, size_t> &lhs,
+               const std::pair<const uint32_t *, size_t> &rhs) {
+              return lhs.second < rhs.second;
+            });
+
+  std::vector<uint32_t> candidates{};
+  if (lists.empty()) {
+    candidates.resize(ends.size());
+    std::iota(candidates.begin(), candidates.end(), 0);
+  } else {
+    candidates.assign(lists[0].first, lists[0].first + lists[0].second);
+    for (size_t i{1}; i < lists.size() && !candidates.empty(); i++) {
+      Intersect(candidates, lists[i].first, lists[i].second);
+    }
+  }
+
+  // a document with every trigram of a longer term may not have the term, and
+  // shorter terms have no trigrams
+  std::vector<uint32_t> out{};
+  for (uint32_t candidate : candidates) {
+    if (std::all_of(lower.begin(), lower.end(),
+                    [this, candidate](const std::string &term) {
+                      return term.size() == LENGTH ||
+                             Contains(candidate, term);
+                    })) {
+      out.push_back(candidate);
+    }
+  }
+  return out;
+}
+
+size_t Index::Bytes() const {
+  return Memory::Bytes(text) + Memory::Bytes(ends) + Memory::Bytes(keys) +
+         Memory::Bytes(offsets) + Memory::Bytes(postings);
+}
+
+bool Index::Contains(uint32_t document, const std::string &term) const {
+  const char *begin = text.data() + (document == 0 ? 0 : ends[document - 1]);
+  const char *end = text.data() + ends[document];
+  return std::search(begin, end, term.begin(), term.end()) != end;
+}
+} // namespace Trigrams
@@ -0,0 +1,79 @@
+/**
+ * @file Trigrams.h
+ * @brief Declares Trigrams::Index, which finds the texts that contain other
+ * texts without reading every text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+
+/**
+ * @brief Trigrams namespace finds the texts containing other texts, e.g. the
+ * heroes with [Advent of in their names, with an inverted index of the
+ * trigrams (every 3 bytes in a row) of the texts. Texts are compared in
+ * lowercase.
+ */
+namespace Trigrams {
+
+/**
+ * @param &text A text
+ * @return the text with ASCII letters in lowercase
+ */
+std::string Lower(const std::string &text);
+
+/**
+ * @brief An inverted index of the trigrams of some texts, called documents,
+ * which are numbered in the order they're given. A text can only be in the
+ * documents that have every one of its trigrams, so the documents with each
+ * trigram of a text are intersected, shortest first, and only those documents
+ * are searched for the text. Texts shorter than a trigram search every
+ * document.
+ */
+class Index {
+public:
+  /** @brief An index of no documents */
+  Index();
+
+  /**
+   * @brief Indexes documents, replacing anything indexed before. The index
+   * has its own lowercase copy of them.
+   * @param &documents The documents
+   * @throw std::runtime_error if the documents are over 4 GB in total
+   */
+  void Build(const std::vector<Text> &documents);
+
+  /**
+   * @param &terms Texts, e.g. {"[advent of", "meliodas"}
+   * @return the numbers of the documents that contain every one of the texts,
+   * in order, or every document if there are no texts
+   */
+  std::vector<uint32_t> Find(const std::vector<std::string> &terms) const;
+
+  /** @return the number of documents */
+  size_t Size() const { return ends.size(); }
+
+  /** @return the memory the index uses, in bytes */
+  size_t Bytes() const;
+
+private:
+  /** @return whether a document contains a lowercase text */
+  bool Contains(uint32_t document, const std::string &term) const;
+
+  /** @brief the documents in lowercase, one after the other */
+  std::string text;
+  /** @brief where each document ends in text */
+  std::vector<uint32_t> ends;
+  /** @brief every distinct trigram, as 3 bytes in a number, sorted */
+  std::vector<uint32_t> keys;
+  /** @brief the documents with keys[i] are postings[offsets[i]] to
+   * postings[offsets[i + 1]], in order */
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> postings;
+};
+} // namespace Trigrams
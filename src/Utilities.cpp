@@ -1,12 +1,29 @@
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "Memory.h"
+#include "Stats.h"
 #include "Utilities.h"
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace Utilities {
 std::vector<std::string> ParseCSV(const std::string &str) {
   std::vector<std::string> out{}; // Initialise output vector
@@ -14,18 +31,11 @@ std::vector<std::string> ParseCSV(const std::string &str) {
     return out;
   }
 
-  std::stringstream ss{str}; // Make a stream out of str
-
   std::string s{};  // Receptacle for each string
   size_t quotes{0}; // Count number of quotes in each string
-  while (true) {
-    char temp{};                        // Receptacle for single character
-    temp = static_cast<char>(ss.get()); // Next character from stream
-    if (ss.eof()) { // Break condition is after getting the next character...
-      out.push_back(s);
-      break;
-    }
-
+  // characters are read straight from str, as reading them from a stream
+  // one at a time is slow
+  for (char temp : str) {
     // The rules for valid CSV imply a quote is part of a string when it's not
     // the first one, then every other
     if (temp == '"') {
@@ -41,13 +51,14 @@ std::vector<std::string> ParseCSV(const std::string &str) {
         s += temp;
       } else {
         out.push_back(s);
-        s = "";
+        s.clear();
         quotes = 0;
       }
     } else {
       s += temp;
     }
   }
+  out.push_back(s);
 
   return out;
 }
@@ -85,6 +96,14 @@ bool EmptyCSV(const std::string &str) {
   return std::all_of(str.begin(), str.end(), [](char ch) { return ch == ','; });
 }
 
+std::string Trim(const std::string &str) {
+  size_t first = str.find_first_not_of(" \t\r");
+  if (first == std::string::npos) {
+    return "";
+  }
+  return str.substr(first, str.find_last_not_of(" \t\r") - first + 1);
+}
+
 std::unordered_map<std::string, std::vector<std::string>>
 ReadLists(const std::string &filename) {
   std::unordered_map<std::string, std::vector<std::string>> out{};
@@ -118,6 +137,8 @@ ReadLists(const std::string &filename) {
                                "draws.txt must not contain duplicates.");
     }
     out[heading] = ParseCSV(data); // adds the list to the hashmap
+    STATS_COUNT("CSV/bytes parsed", heading.size() + data.size() + 2);
+    STATS_COUNT("CSV/rows parsed", 1);
 
     // empty line
     std::getline(file,
@@ -130,4 +151,130 @@ ReadLists(const std::string &filename) {
   return out;
 }
 
+std::vector<std::string> ReadLines(const std::string &filename) {
+  std::ifstream file{filename, std::ios::binary};
+  std::vector<std::string> out{};
+  if (!file.good()) {
+    return out;
+  }
+  std::stringstream ss{};
+  ss << file.rdbuf();
+  const std::string contents = ss.str();
+
+  size_t start{0};
+  while (start < contents.size()) {
+    size_t end = contents.find('\n', start);
+    if (end == std::string::npos) {
+      end = contents.size();
+    }
+    out.push_back(contents.substr(start, end - start));
+    start = end + 1;
+  }
+  return out;
+}
+
+void ParallelFor(size_t count,
+                 const std::function<void(size_t, size_t)> &function,
+                 size_t min_range) {
+  min_range = std::max<size_t>(min_range, 1);
+  size_t threads = std::max(1U, std::thread::hardware_concurrency());
+  threads = std::min(threads, (count + min_range - 1) / min_range);
+  if (threads <= 1) {
+    function(0, count);
+    return;
+  }
+
+  // this thread does the first range while the other threads do the rest
+  size_t range = (count + threads - 1) / threads;
+  std::vector<std::future<void>> futures{};
+  for (size_t begin{range}; begin < count; begin += range) {
+    futures.push_back(
+        Memory::Async(function, begin, std::min(count, begin + range)));
+  }
+  function(0, range);
+  for (auto &future : futures) {
+    future.get();
+  }
+}
+
+uint32_t Crc32(const std::string &str) {
+  // table of the checksums of every byte, computed the first time
+  static const std::array<uint32_t, 256> table = []() {
+    std::array<uint32_t, 256> out{};
+    for (uint32_t i{0}; i < out.size(); i++) {
+      uint32_t crc = i;
+      for (int bit{0}; bit < 8; bit++) {
+        crc = (crc & 1U) ? 0xEDB88320U ^ (crc >> 1) : crc >> 1;
+      }
+      out[i] = crc;
+    }
+    return out;
+  }();
+
+  uint32_t crc = 0xFFFFFFFFU;
+  for (const char &ch : str) {
+    crc = table[(crc ^ static_cast<unsigned char>(ch)) & 0xFFU] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFU;
+}
+
+void SyncFile(std::FILE *file) {
+  if (std::fflush(file) != 0) {
+    throw std::runtime_error("Could not write to a data file.");
+  }
+#ifdef _WIN32
+  int result = _commit(_fileno(file));
+#else
+  int result = fsync(fileno(file));
+#endif
+  if (result != 0) {
+    throw std::runtime_error("Could not save a data file to disk.");
+  }
+}
+
+void WriteFileAtomically(const std::string &filename,
+                         const std::string &contents) {
+  // write and save the temporary file
+  std::string temporary = filename + ".tmp";
+  std::FILE *file = std::fopen(temporary.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("Could not open " + temporary + " to write.");
+  }
+  bool written =
+      std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+  try {
+    SyncFile(file);
+  } catch (const std::runtime_error &) {
+    written = false;
+  }
+  std::fclose(file);
+  if (!written) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Could not write " + temporary + ".");
+  }
+
+  // replace the file with the temporary file
+#ifdef _WIN32
+  bool renamed =
+      MoveFileExA(temporary.c_str(), filename.c_str(),
+                  MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  bool renamed = std::rename(temporary.c_str(), filename.c_str()) == 0;
+  if (renamed) {
+    // the rename itself is saved by saving the directory
+    size_t slash = filename.find_last_of('/');
+    std::string directory =
+        slash == std::string::npos ? "." : filename.substr(0, slash);
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      fsync(fd);
+      close(fd);
+    }
+  }
+#endif
+  if (!renamed) {
+    throw std::runtime_error("Could not replace " + filename + ".");
+  }
+}
+
 } // namespace Utilities
\ No newline at end of file
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <cstdio>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -34,6 +36,13 @@ std::string MakeCSV(const std::vector<std::string> &vec);
  * commas) */
 bool EmptyCSV(const std::string &str);
 
+/**
+ * @param &str A string
+ * @return the string without the spaces, tabs and carriage returns at its
+ * start and end
+ */
+std::string Trim(const std::string &str);
+
 /**
  * Reads data from a text file into a hashmap. The format of the file contents
  * is expected to be: \n Heading \\n \n Comma-separated list \\n \n (Empty line)
@@ -49,6 +58,54 @@ bool EmptyCSV(const std::string &str);
 std::unordered_map<std::string, std::vector<std::string>>
 ReadLists(const std::string &filename);
 
+/**
+ * @brief Reads a whole file at once, and splits it into lines.
+ * @param &filename A string, the name of the file
+ * @return the lines, without the line breaks, or an empty list if the file
+ * can't be opened
+ */
+std::vector<std::string> ReadLines(const std::string &filename);
+
+/**
+ * @brief Splits the numbers 0 to count - 1 into ranges and calls function for
+ * each range, in separate threads (at most one for each CPU core). Small
+ * counts aren't split, since starting threads takes longer than they save.
+ * @param count The number of items
+ * @param &function A function taking the first and one past the last item of a
+ * range. It's called at the same time for different ranges.
+ * @param min_range The fewest items worth a thread of their own, e.g. fewer
+ * for items that take long
+ * @throw anything function throws
+ */
+void ParallelFor(size_t count,
+                 const std::function<void(size_t, size_t)> &function,
+                 size_t min_range = 1024);
+
+/**
+ * @param &str Any string
+ * @return the CRC-32 checksum of str (the one used by e.g. zip and PNG)
+ */
+uint32_t Crc32(const std::string &str);
+
+/**
+ * @brief Makes sure everything written to a file so far is stored on disk,
+ * not just in a buffer, so it survives the program or computer crashing.
+ * @param file An open file
+ * @throw std::runtime_error if it fails
+ */
+void SyncFile(std::FILE *file);
+
+/**
+ * @brief Replaces the contents of a file, so that after a crash the file has
+ * either the old or the new contents and never part of each. The contents are
+ * written to a temporary file (filename.tmp) which is then renamed.
+ * @param &filename The name of the file
+ * @param &contents The new contents of the file
+ * @throw std::runtime_error if the file can't be written
+ */
+void WriteFileAtomically(const std::string &filename,
+                         const std::string &contents);
+
 /**
  * @brief Overload << for vectors using << operator for the elements,
  * separated by commas. Does nothing if vec is empty. */
@@ -56,22 +113,12 @@ template <typename T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &vec);
 
 /**
- * @brief Given an array and a condition, returns a vector of iterators,
- * pointing to the elements of the original array.
+ * @brief Given a vector and a condition, returns the indices of the elements
+ * of the vector that meet the condition, in order.
  */
-template <typename T, size_t L>
-std::vector<typename std::array<T, L>::iterator>
-Select(std::array<T, L> &vec, const std::function<bool(const T &)> &condition);
-
-/**
- * @brief Checks the size and data types of a list of data. The parameters
- * numerical_data and boolean_data are lists of indices. Throws an error if the
- * data is different from what it should be.
- */
-template <size_t L1, size_t L2>
-void ValidateList(const std::vector<std::string> &data, size_t data_size,
-                  const std::array<size_t, L1> &numerical_data,
-                  const std::array<size_t, L2> &boolean_data);
+template <typename T>
+std::vector<size_t> Select(const std::vector<T> &vec,
+                           const std::function<bool(const T &)> &condition);
 
 #include "Utilities.tpp"
 
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Cache.h"
+#include "Catalog.h"
+#include "Filter.h"
+#include "Hero.h"
+#include "Memory.h"
+#include "Views.h"
+
+namespace Views {
+
+namespace {
+/** @brief Sets whether a hero is in a view's result, remembering the change */
+void SetRow(View &view, size_t index, bool value) {
+  if (view.rows[index] == value) {
+    return;
+  }
+  // only the first change since TakeDeltas knows what the row was before
+  view.changed.insert({index, view.rows[index]});
+  view.rows[index] = value;
+  if (value) {
+    view.count++;
+  } else {
+    view.count--;
+  }
+}
+} // namespace
+
+void Register(Catalog &catalog, const std::string &name,
+              const Filter::Expression &expression) {
+  MEMORY_PHASE("Views::Register");
+  for (const View &view : catalog.views) {
+    if (view.name == name) {
+      throw std::invalid_argument("The view " + name + " already exists.");
+    }
+  }
+
+  // the first evaluation is an ordinary filter, so it may be cached
+  std::shared_ptr<const std::vector<bool>> rows =
+      Cache::Evaluate(catalog, expression);
+  View view{name, expression, Filter::Compile(catalog, expression), *rows,
+            static_cast<size_t>(std::count(rows->begin(), rows->end(), true)),
+            {}};
+  catalog.views.push_back(view);
+}
+
+void Remove(Catalog &catalog, const std::string &name) {
+  std::vector<View> &views = catalog.views;
+  auto it =
+      std::find_if(views.begin(), views.end(),
+                   [&name](const View &view) { return view.name == name; });
+  if (it == views.end()) {
+    throw std::invalid_argument("There is no view called " + name + ".");
+  }
+  views.erase(it);
+}
+
+void Update(Catalog &catalog, const Hero &hero) {
+  for (View &view : catalog.views) {
+    SetRow(view, hero.index, view.condition(hero));
+  }
+}
+
+void Refresh(Catalog &catalog) {
+  for (View &view : catalog.views) {
+    // the conditions may hold data (e.g. tier lists), so compile them again
+    view.condition = Filter::Compile(catalog, view.expression);
+    view.rows.resize(catalog.list.size(), false);
+    for (size_t i{0}; i < catalog.list.size(); i++) {
+      SetRow(view, i, view.condition(catalog.list[i]));
+    }
+  }
+}
+
+void Rebuild(Catalog &catalog) {
+  for (View &view : catalog.views) {
+    // the conditions may hold data (e.g. tier lists), so compile them again
+    view.condition = Filter::Compile(catalog, view.expression);
+    view.rows.assign(catalog.list.size(), false);
+    view.count = 0;
+    view.changed.clear();
+    for (size_t i{0}; i < catalog.list.size(); i++) {
+      if (view.condition(catalog.list[i])) {
+        view.rows[i] = true;
+        view.count++;
+      }
+    }
+  }
+}
+
+std::vector<Delta> TakeDeltas(Catalog &catalog) {
+  std::vector<Delta> out{};
+  for (View &view : catalog.views) {
+    Delta delta{view.name, {}, {}};
+    for (const auto &item : view.changed) {
+      if (item.first >= view.rows.size() ||
+          view.rows[item.first] == item.second) {
+        continue; // changed back, or the hero no longer exists
+      }
+      if (view.rows[item.first]) {
+        delta.added.push_back(item.first);
+      } else {
+        delta.removed.push_back(item.first);
+      }
+    }
+    view.changed.clear();
+
+    if (!delta.added.empty() || !delta.removed.empty()) {
+      std::sort(delta.added.begin(), delta.added.end());
+      std::sort(delta.removed.begin(), delta.removed.end());
+      out.push_back(delta);
+    }
+  }
+  return out;
+}
+} // namespace Views
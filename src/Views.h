@@ -0,0 +1,105 @@
+/**
+ * @file Views.h
+ * @brief Views namespace contains the saved filters whose results are kept up
+ * to date as heroes change.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Filter.h"
+#include "Hero.h"
+
+struct Catalog;
+
+/**
+ * @brief Views namespace contains the saved filters whose results are kept up
+ * to date as heroes change.
+ */
+namespace Views {
+
+/**
+ * @brief A view is a named filter and its result. When a hero changes, only
+ * that hero is checked again.
+ */
+struct View {
+  /** @brief a name for the view */
+  std::string name;
+  /** @brief the filter */
+  Filter::Expression expression;
+  /** @brief the compiled filter */
+  Filter::Condition condition;
+  /** @brief whether each hero is in the result, indexed by Hero::index */
+  std::vector<bool> rows;
+  /** @brief the number of heroes in the result */
+  size_t count;
+  /** @brief the heroes that changed since the last TakeDeltas, and whether
+   * they were in the result before that: { Hero index => was in result } */
+  std::unordered_map<size_t, bool> changed;
+};
+
+/** @brief The changes to the result of a view */
+struct Delta {
+  /** @brief the name of the view */
+  std::string view;
+  /** @brief Hero indices of heroes that are new in the result */
+  std::vector<size_t> added;
+  /** @brief Hero indices of heroes that are no longer in the result */
+  std::vector<size_t> removed;
+};
+
+/**
+ * @brief Saves a filter as a view and evaluates it for every hero.
+ * @param &catalog The catalog to save the view in
+ * @param &name The name of the view
+ * @param &expression The filter
+ * @throw std::invalid_argument if a view with that name already exists, or
+ * the filter is invalid
+ */
+void Register(Catalog &catalog, const std::string &name,
+              const Filter::Expression &expression);
+
+/**
+ * @brief Removes a view.
+ * @param &catalog The catalog the view is saved in
+ * @param &name The name of the view
+ * @throw std::invalid_argument if there is no view with that name
+ */
+void Remove(Catalog &catalog, const std::string &name);
+
+/**
+ * @brief Checks one hero against every view again. It should be called every
+ * time a hero changes.
+ * @param &catalog The catalog the hero is in
+ * @param &hero The hero that changed
+ */
+void Update(Catalog &catalog, const Hero &hero);
+
+/**
+ * @brief Evaluates every view for every hero again, e.g. after a profile is
+ * loaded. The heroes must be the same ones, in the same order. Pending changes
+ * are kept.
+ * @param &catalog The catalog
+ */
+void Refresh(Catalog &catalog);
+
+/**
+ * @brief Evaluates every view from scratch after a new dataset is installed,
+ * e.g. when the data files are read again. Heroes may have been added, removed
+ * or moved, so a hero's index may now be another hero's: pending changes are
+ * forgotten rather than compared by position.
+ * @param &catalog The catalog
+ */
+void Rebuild(Catalog &catalog);
+
+/**
+ * @brief Returns what changed in each view since it was last called, and
+ * forgets it. Heroes that changed back are not included.
+ * @param &catalog The catalog
+ * @return the changes of the views that changed
+ */
+std::vector<Delta> TakeDeltas(Catalog &catalog);
+} // namespace Views
@@ -1,20 +1,401 @@
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "AddOwned.h"
+#include "Cache.h"
+#include "Catalog.h"
+#include "Cursor.h"
+#include "Diff.h"
+#include "Explain.h"
 #include "Filter.h"
+#include "GroupBy.h"
 #include "Hero.h"
 #include "Heroes.h"
+#include "Journal.h"
+#include "Memory.h"
 #include "Menu.h"
+#include "Order.h"
 #include "Project.h"
+#include "Reload.h"
+#include "Render.h"
+#include "Search.h"
+#include "Stats.h"
+#include "Utilities.h"
+#include "Views.h"
+
+namespace {
+/** @brief The number of heroes shown at a time in the menu */
+constexpr size_t PAGE_SIZE{20};
+
+/** @brief The command line options */
+struct Options {
+  /** @brief --batch filters standard input instead of showing the menu */
+  bool batch;
+  /** @brief --explain shows how each filter in batch mode is evaluated */
+  bool explain;
+  /** @brief --memory and --stats report how much memory everything used and
+   * how long it took when the program ends */
+  bool memory;
+  bool stats;
+  /** @brief --offset and --limit: the number of heroes each filter in batch
+   * mode skips, and the most it shows after that */
+  size_t offset;
+  size_t limit;
+  /** @brief --order: the order of the heroes each filter in batch mode finds,
+   * or empty for the order of heroes.csv */
+  std::vector<Order::Key> order;
+  /** @brief --format: how batch mode writes the heroes it finds */
+  Render::Format format;
+  /** @brief --group-by and --aggregate: the keys and aggregates of a table
+   * each filter in batch mode summarizes its heroes in, instead of writing
+   * them, and whether either was given */
+  std::vector<std::string> group_by;
+  std::string aggregate;
+  bool grouped;
+  /** @brief --import: a list of owned heroes to import, instead of showing
+   * the menu */
+  std::string import;
+  /** @brief --diff: a list of pairs of owned heroes files to compare,
+   * instead of showing the menu */
+  std::string diff;
+  /** @brief --data: the directory of the data files */
+  std::string data_dir;
+};
+
+/**
+ * @brief Finds every hero a filter finds, with the cache.
+ * @return the indices of the heroes in Catalog::list
+ */
+std::vector<size_t> Evaluate(Catalog &catalog,
+                             const Filter::Expression &expression) {
+  std::shared_ptr<const std::vector<bool>> result =
+      Cache::Evaluate(catalog, expression);
+  std::vector<size_t> rows{};
+  for (size_t i{0}; i < result->size(); i++) {
+    if ((*result)[i]) {
+      rows.push_back(i);
+    }
+  }
+  return rows;
+}
+
+/**
+ * @brief Reads the command line options.
+ * @return whether they're valid
+ */
+bool ParseOptions(int argc, char *argv[], Options &options) {
+  for (int i{1}; i < argc; i++) {
+    std::string arg{argv[i]};
+    bool value = i + 1 < argc;
+    try {
+      if (arg == "--batch") {
+        options.batch = true;
+      } else if (arg == "--explain") {
+        options.explain = true;
+      } else if (arg == "--memory") {
+        options.memory = true;
+      } else if (arg == "--stats") {
+        options.stats = true;
+      } else if (arg == "--offset" && value) {
+        options.offset = static_cast<size_t>(std::stoul(argv[++i]));
+      } else if (arg == "--limit" && value) {
+        options.limit = static_cast<size_t>(std::stoul(argv[++i]));
+      } else if (arg == "--order" && value) {
+        options.order = Order::Parse(argv[++i]);
+      } else if (arg == "--format" && value) {
+        options.format = Render::ParseFormat(argv[++i]);
+      } else if (arg == "--group-by" && value) {
+        options.group_by = GroupBy::ParseKeys(argv[++i]);
+        options.grouped = true;
+      } else if (arg == "--aggregate" && value) {
+        options.aggregate = argv[++i];
+        options.grouped = true;
+      } else if (arg == "--import" && value) {
+        options.import = argv[++i];
+      } else if (arg == "--diff" && value) {
+        options.diff = argv[++i];
+      } else if (arg == "--data" && value) {
+        options.data_dir = argv[++i];
+      } else {
+        return false;
+      }
+    } catch (std::exception &ex) {
+      // std::stoul throws if it isn't a number, Order::Parse if it isn't an
+      // order, Render::ParseFormat if it isn't a format and
+      // GroupBy::ParseKeys if it isn't a list of keys
+      std::cerr << ex.what() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Runs the filters read from standard input, one on each line in the
+ * form Filter::ToString writes, e.g. And(Owned(), Good(1)). The heroes each
+ * filter finds are written in the --format (by default their names on
+ * separate lines), followed by an empty line. Invalid filters are reported on
+ * standard error, and find no heroes.
+ * @param &catalog The catalog to filter
+ * @param &options With --explain, how each filter is evaluated (see
+ * Explain::Print) is written instead of the heroes it finds. Heroes are only
+ * checked until --offset and --limit are satisfied, unless they're sorted by
+ * --order; then only the first --offset + --limit are sorted. With
+ * --group-by or --aggregate, a table of the groups of the heroes is written
+ * instead (see GroupBy::Run), as a table for --format names.
+ * @return the exit status: whether every filter was valid
+ */
+int Batch(Catalog &catalog, const Options &options) {
+  int status{EXIT_SUCCESS};
+  std::vector<GroupBy::Aggregate> aggregates{};
+  if (options.grouped) {
+    try {
+      aggregates = GroupBy::ParseAggregates(catalog, options.aggregate);
+    } catch (std::exception &ex) {
+      std::cerr << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::string line{};
+  while (std::getline(std::cin, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    try {
+      Filter::Expression expression = Filter::Parse(line);
+      if (options.explain) {
+        Explain::Print(std::cout, Explain::Analyze(catalog, expression));
+      } else if (options.grouped) {
+        GroupBy::Table table =
+            GroupBy::Run(catalog, Evaluate(catalog, expression),
+                         options.group_by, aggregates);
+        Render::WriteTable(std::cout, table.headings, table.rows,
+                           options.format);
+      } else if (!options.order.empty()) {
+        Render::Renderer renderer{std::cout, catalog, options.format};
+        std::vector<size_t> rows = Evaluate(catalog, expression);
+        size_t count = rows.size();
+        if (options.limit < rows.size()) {
+          count = std::min(rows.size(), options.offset + options.limit);
+        }
+        std::vector<size_t> sorted =
+            Order::Top(catalog, rows, options.order, count);
+        for (size_t i{options.offset}; i < sorted.size(); i++) {
+          renderer.Add(catalog.list[sorted[i]]);
+        }
+      } else {
+        Render::Renderer renderer{std::cout, catalog, options.format};
+        Cursor cursor{catalog, expression, options.offset};
+        size_t index{0};
+        for (size_t i{0}; i < options.limit && cursor.Next(index); i++) {
+          renderer.Add(catalog.list[index]);
+        }
+      }
+    } catch (std::exception &ex) {
+      std::cerr << ex.what() << std::endl;
+      status = EXIT_FAILURE;
+    }
+    std::cout << std::endl;
+  }
+  return status;
+}
+
+/**
+ * @brief Imports a list of owned heroes from a file (see AddOwned::ParseImport)
+ * after showing the changes and asking once to confirm them.
+ * @param &catalog The catalog
+ * @param &filename The file
+ * @return the exit status: whether the list was valid
+ */
+int Import(Catalog &catalog, const std::string &filename) {
+  try {
+    if (!std::ifstream{filename}.good()) {
+      throw std::runtime_error("Could not open " + filename + ".");
+    }
+    std::vector<AddOwned::Change> changes = AddOwned::ParseImport(
+        catalog, Utilities::ReadLines(filename), filename);
+    if (changes.empty()) {
+      std::cout << "The owned heroes are already up to date." << std::endl;
+    } else {
+      AddOwned::PrintChanges(std::cout, catalog, changes);
+      if (Menu::YesOrNoInput("Save these changes?")) {
+        AddOwned::ApplyImport(catalog, changes);
+        std::cout << "data/owned.csv file updated." << std::endl;
+      }
+    }
+  } catch (std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Compares pairs of owned heroes files listed in a file, one pair on
+ * each line, e.g. before.csv, after.csv (see Diff::CompareFiles). With
+ * --format names or text, the differences of each pair are printed as
+ * Diff::Print does; otherwise there's one table of every pair's differences
+ * (see Diff::Rows) with the pair's files in the first two columns. Pairs that
+ * can't be compared are reported on standard error.
+ * @param &catalog The catalog
+ * @param &options The file and the --format
+ * @return the exit status: whether every pair was compared
+ */
+int CompareSnapshots(const Catalog &catalog, const Options &options) {
+  if (!std::ifstream{options.diff}.good()) {
+    std::cerr << "Could not open " << options.diff << "." << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<std::pair<std::string, std::string>> pairs{};
+  std::vector<std::string> lines = Utilities::ReadLines(options.diff);
+  for (size_t i{0}; i < lines.size(); i++) {
+    if (Utilities::EmptyCSV(lines[i])) {
+      continue;
+    }
+    std::vector<std::string> files = Utilities::ParseCSV(lines[i]);
+    if (files.size() != 2) {
+      std::cerr << options.diff << " line " << i + 1
+                << ": expected 2 files, found " << files.size() << "."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    pairs.emplace_back(Utilities::Trim(files[0]), Utilities::Trim(files[1]));
+  }
+
+  int status{EXIT_SUCCESS};
+  std::vector<Diff::Result> results = Diff::CompareFiles(catalog, pairs);
+  bool text = options.format == Render::Format::NAMES ||
+              options.format == Render::Format::TEXT;
+  std::vector<std::string> headings{"BeforeFile", "AfterFile"};
+  headings.insert(headings.end(), Diff::headings.begin(),
+                  Diff::headings.end());
+  std::vector<std::vector<std::string>> rows{};
+  for (size_t i{0}; i < results.size(); i++) {
+    if (!results[i].error.empty()) {
+      std::cerr << results[i].error << std::endl;
+      status = EXIT_FAILURE;
+    } else if (text) {
+      std::cout << pairs[i].first << " -> " << pairs[i].second << ":"
+                << std::endl;
+      Diff::Print(std::cout, catalog, results[i].differences);
+      std::cout << std::endl;
+    } else {
+      for (std::vector<std::string> &row :
+           Diff::Rows(catalog, results[i].differences)) {
+        row.insert(row.begin(), {pairs[i].first, pairs[i].second});
+        rows.push_back(std::move(row));
+      }
+    }
+  }
+  if (!text) {
+    Render::WriteTable(std::cout, headings, rows, options.format);
+  }
+  return status;
+}
+
+/**
+ * @brief Asks whether to sort the heroes a filter finds, and by which columns.
+ * @return the order, or empty to keep the order of heroes.csv
+ */
+std::vector<Order::Key> GetOrder() {
+  std::vector<Order::Key> order{};
+  if (!Menu::YesOrNoInput("Want to sort the heroes?")) {
+    return order;
+  }
+  std::vector<std::string> names{};
+  for (const Order::Column &column : Order::columns) {
+    names.push_back(column.name);
+  }
+  do {
+    size_t int_input =
+        Menu::AskForInput("Please select a column to sort by.", names);
+    bool descending = Menu::YesOrNoInput("Should the highest come first?");
+    order.push_back({Order::columns[int_input - 1].name, descending});
+  } while (Menu::YesOrNoInput("Want to sort heroes that are equal by another "
+                              "column?"));
+  std::cout << "Sorting by " << Order::ToString(order) << "." << std::endl;
+  return order;
+}
+
+/**
+ * @brief Shows heroes a page at a time, asking before each page after the
+ * first, then how many were found if every page was shown.
+ * @param &catalog The catalog the heroes are in
+ * @param &take Gives the indices of the heroes of the next page
+ * @param &done Whether there are no more heroes
+ */
+void ShowPages(Catalog &catalog,
+               const std::function<std::vector<size_t>()> &take,
+               const std::function<bool()> &done) {
+  Render::Renderer renderer{std::cout, catalog, Render::Format::TEXT};
+  size_t shown{0};
+  while (true) {
+    std::vector<size_t> page = take();
+    renderer.Add(page);
+    renderer.Finish();
+    shown += page.size();
+    if (done()) {
+      break;
+    }
+    std::cout << std::endl
+              << "Shown " << shown
+              << " heroes so far. Press enter to see more, or x to stop."
+              << std::endl;
+    std::string x{};
+    std::getline(std::cin, x);
+    if (x == "x") {
+      return;
+    }
+  }
+  std::cout << std::endl
+            << "Found: " << shown << " out of " << catalog.list.size()
+            << " heroes." << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options{false, false, false, false, 0,
+                  std::numeric_limits<size_t>::max(), {},
+                  Render::Format::NAMES, {}, "Count, Owned", false,
+                  "", "", "../data"};
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--batch [--explain] [--offset N] [--limit N]"
+                 " [--order KEYS] [--format names|text|csv|jsonl|table]"
+                 " [--group-by KEYS] [--aggregate AGGREGATES]]"
+                 " [--import FILE] [--diff FILE] [--stats] [--memory]"
+                 " [--data DIR]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  Stats::Enable(options.stats);
 
-int main() {
   // Read data files and generate list of heroes
+  Catalog catalog{options.data_dir};
+  // in batch mode, messages about the data go to standard error, so standard
+  // output only has the heroes found
+  std::streambuf *output = std::cout.rdbuf();
+  if (options.batch) {
+    std::cout.rdbuf(std::cerr.rdbuf());
+  }
   try {
-    Heroes::MakeHeroes();
+    Heroes::MakeHeroes(catalog);
+    for (const std::string &notice : catalog.notices) {
+      std::cout << notice << std::endl;
+    }
+    Journal::Recover(catalog);
+    std::cout.rdbuf(output);
   } catch (std::exception &ex) {
+    std::cout.rdbuf(output);
     // should make custom exception types
     // e.g. exceptions are thrown when a data file isn't found or has invalid
     // data. these errors aren't recoverable, i.e. the data needs to be changed
@@ -23,43 +404,301 @@ int main() {
     return EXIT_FAILURE;
   }
 
+  if (!options.import.empty()) {
+    return Import(catalog, options.import);
+  }
+
+  if (!options.diff.empty()) {
+    int status = CompareSnapshots(catalog, options);
+    if (options.stats) {
+      std::cerr << Stats::ToJSON() << std::endl;
+    }
+    return status;
+  }
+
+  if (options.batch) {
+    int status = Batch(catalog, options);
+    if (options.stats) {
+      std::cerr << Stats::ToJSON() << std::endl;
+    }
+    if (options.memory) {
+      std::cerr << Memory::ToJSON(catalog) << std::endl;
+    }
+    return status;
+  }
+
   std::cout << "Data files ok" << std::endl;
   std::cout << std::endl;
 
+  // Read the data files again whenever they change
+  catalog.watcher.reset(new Reload::Watcher{catalog.data_dir});
+  catalog.watcher->Start();
+
   // Run the program loop. This allows the user to use the program until they
   // close it.
   std::string x{};
   while (true) {
-    Menu::TopLevelMenu();
+    Menu::TopLevelMenu(catalog, Menu::menu_functions);
     std::cout << std::endl << std::endl;
     std::cout << "Press x to exit, anything else to continue. " << std::endl;
     std::getline(std::cin, x);
     if (x == "x") {
+      catalog.watcher->Stop();
+      if (options.stats) {
+        std::cout << std::endl;
+        Stats::Print(std::cout);
+      }
+      if (options.memory) {
+        std::cout << std::endl;
+        Memory::Print(std::cout, catalog);
+      }
       return EXIT_SUCCESS;
     }
   }
 }
 
-void Menu_Filter() {
-  std::vector<std::array<Hero, Heroes::COUNT>::iterator> filtered =
-      Filter::Filter();
+void Menu_Filter(Catalog &catalog) {
+  Filter::Expression expression = Filter::GetFilter(catalog);
+  std::cout << std::endl;
+  std::vector<Order::Key> order = GetOrder();
+  std::cout << std::endl << std::endl;
 
-  std::cout << "Press enter to view results." << std::endl;
-  std::string x{};
-  std::getline(std::cin, x);
+  if (order.empty()) {
+    // heroes are only checked until a page is found, so the first page comes
+    // straight away even for filters that match most heroes
+    Cursor cursor{catalog, expression};
+    ShowPages(
+        catalog, [&cursor]() { return cursor.Take(PAGE_SIZE); },
+        [&cursor]() { return cursor.Done(); });
+    return;
+  }
+
+  std::vector<size_t> rows = Evaluate(catalog, expression);
+  rows = Order::Sort(catalog, rows, order);
+  size_t position{0};
+  ShowPages(
+      catalog,
+      [&rows, &position]() {
+        size_t end = std::min(position + PAGE_SIZE, rows.size());
+        std::vector<size_t> page(rows.begin() + position, rows.begin() + end);
+        position = end;
+        return page;
+      },
+      [&rows, &position]() { return position == rows.size(); });
+}
+
+void Menu_AddOwned(Catalog &catalog) {
+  size_t int_input = Menu::AskForInput(
+      "You can choose how to add owned heroes.",
+      {"Choose heroes with a filter, and update them one at a time",
+       "Import a list pasted here", "Import a list from a file"});
+  std::cout << std::endl;
+
+  if (int_input == 1) {
+    std::cout << "Please select the heroes you want to update." << std::endl;
+    std::vector<size_t> heroes = Filter::Filter(catalog);
+
+    AddOwned::UpdateHeroes(catalog, heroes);
 
-  for (const auto &it : filtered) {
-    std::cout << *it << std::endl;
+    // the updates are already saved in the journal; sometimes it's compacted
+    if (Journal::CompactIfNeeded(catalog)) {
+      std::cout << "data/owned.csv file updated." << std::endl;
+    } else {
+      std::cout << "data/owned.journal file updated." << std::endl;
+    }
+  } else {
+    std::vector<std::string> lines{};
+    std::string source_name{};
+    if (int_input == 2) {
+      std::cout << "Please paste the heroes, one on each line: hero, grade, "
+                   "level, stars, unique, ultimate. Parts of hero names are "
+                   "fine. End with an empty line."
+                << std::endl;
+      std::string line{};
+      while (std::getline(std::cin, line) && !line.empty()) {
+        lines.push_back(line);
+      }
+      source_name = "the pasted list";
+    } else {
+      source_name = Menu::GetFreeInput("Please enter the file's path");
+      if (!std::ifstream{source_name}.good()) {
+        std::cout << "Could not open " << source_name << "." << std::endl;
+        return;
+      }
+      lines = Utilities::ReadLines(source_name);
+    }
+
+    // nothing changes unless every line is valid
+    std::vector<AddOwned::Change> changes{};
+    try {
+      changes = AddOwned::ParseImport(catalog, lines, source_name);
+    } catch (std::runtime_error &ex) {
+      std::cout << ex.what() << std::endl;
+      return;
+    }
+    if (changes.empty()) {
+      std::cout << "The owned heroes are already up to date." << std::endl;
+      return;
+    }
+    AddOwned::PrintChanges(std::cout, catalog, changes);
+    if (!Menu::YesOrNoInput("Save these changes?")) {
+      return;
+    }
+    AddOwned::ApplyImport(catalog, changes);
+    std::cout << "data/owned.csv file updated." << std::endl;
+  }
+
+  // show how the saved views changed
+  for (const Views::Delta &delta : Views::TakeDeltas(catalog)) {
+    std::cout << std::endl << "View " << delta.view << ":" << std::endl;
+    for (size_t index : delta.added) {
+      std::cout << "+ " << catalog.list[index].hero << std::endl;
+    }
+    for (size_t index : delta.removed) {
+      std::cout << "- " << catalog.list[index].hero << std::endl;
+    }
   }
 }
 
-void Menu_AddOwned() {
-  std::cout << "Please select the heroes you want to update." << std::endl;
-  std::vector<std::array<Hero, Heroes::COUNT>::iterator> heroes =
-      Filter::Filter();
+void Menu_Views(Catalog &catalog) {
+  size_t int_input = Menu::AskForInput(
+      "You can choose from the following view options.",
+      {"Save a new view", "Show views", "Remove a view"});
+  std::cout << std::endl;
 
-  AddOwned::UpdateHeroes(heroes);
+  if (int_input == 1) {
+    std::string name = Menu::GetFreeInput("Please enter a name for the view");
+    Filter::Expression expression = Filter::GetFilter(catalog);
+    std::cout << std::endl;
+    Views::Register(catalog, name, expression);
+    std::cout << "View " << name << " saved with "
+              << catalog.views.back().count << " heroes." << std::endl;
+    return;
+  }
 
-  AddOwned::UpdateFile();
-  std::cout << "data/owned.csv file updated." << std::endl;
-}
\ No newline at end of file
+  if (catalog.views.empty()) {
+    std::cout << "There are no saved views." << std::endl;
+    return;
+  }
+  std::vector<std::string> names{};
+  for (const Views::View &view : catalog.views) {
+    names.push_back(view.name + ": " + Filter::ToString(view.expression) +
+                    " (" + std::to_string(view.count) + " heroes)");
+  }
+
+  if (int_input == 2) {
+    int_input = Menu::AskForInput("Please select a view to see its heroes.",
+                                  names);
+    std::cout << std::endl;
+    const Views::View &view = catalog.views[int_input - 1];
+    Render::Renderer renderer{std::cout, catalog, Render::Format::TEXT};
+    for (size_t i{0}; i < view.rows.size(); i++) {
+      if (view.rows[i]) {
+        renderer.Add(catalog.list[i]);
+      }
+    }
+  } else {
+    int_input = Menu::AskForInput("Please select a view to remove.", names);
+    std::cout << std::endl;
+    Views::Remove(catalog, catalog.views[int_input - 1].name);
+  }
+}
+
+void Menu_Explain(Catalog &catalog) {
+  Filter::Expression expression = Filter::GetFilter(catalog);
+  std::cout << std::endl << std::endl;
+  Explain::Print(std::cout, Explain::Analyze(catalog, expression));
+}
+
+void Menu_Search(Catalog &catalog) {
+  std::string text = Menu::GetFreeInput(
+      "Please enter part of a hero, name or character, e.g. tavern");
+  std::vector<Search::Suggestion> suggestions =
+      catalog.search.Suggest(text, 10);
+  if (suggestions.empty()) {
+    std::cout << "Nothing was found for " << text << "." << std::endl;
+    return;
+  }
+  std::vector<std::string> labels{};
+  for (const Search::Suggestion &suggestion : suggestions) {
+    labels.push_back(suggestion.text.str() + " (" +
+                     Search::FieldName(suggestion.field) + ", " +
+                     std::to_string(suggestion.heroes.size()) +
+                     (suggestion.heroes.size() == 1 ? " hero)" : " heroes)"));
+  }
+  size_t int_input =
+      Menu::AskForInput("Please select one to see its heroes.", labels);
+  std::cout << std::endl;
+  Render::Renderer renderer{std::cout, catalog, Render::Format::TEXT};
+  for (size_t row : suggestions[int_input - 1].heroes) {
+    renderer.Add(catalog.list[row]);
+  }
+}
+
+void Menu_Aggregate(Catalog &catalog) {
+  Filter::Expression expression = Filter::GetFilter(catalog);
+  std::cout << std::endl;
+  std::string key_names{};
+  for (const GroupBy::Key &key : GroupBy::keys) {
+    key_names += (key_names.empty() ? "" : ", ") + key.name;
+  }
+  std::string keys_text = Menu::GetFreeInput(
+      "Please enter the keys to group the heroes by, separated by commas, or "
+      "nothing for one group (" +
+      key_names + ")");
+  std::string aggregates_text = Menu::GetFreeInput(
+      "Please enter the aggregates, e.g. Count, PercentOwned, Avg(Ultimate), "
+      "Max(Level), Min(BestTier), or nothing for Count, Owned");
+  if (Utilities::Trim(aggregates_text).empty()) {
+    aggregates_text = "Count, Owned";
+  }
+
+  GroupBy::Table table{};
+  try {
+    table = GroupBy::Run(catalog, Evaluate(catalog, expression),
+                         GroupBy::ParseKeys(keys_text),
+                         GroupBy::ParseAggregates(catalog, aggregates_text));
+  } catch (std::invalid_argument &ex) {
+    std::cout << ex.what() << std::endl;
+    return;
+  }
+  Render::WriteTable(std::cout, table.headings, table.rows,
+                     Render::Format::TABLE);
+}
+
+void Menu_Compare(Catalog &catalog) {
+  std::string before = Menu::GetFreeInput(
+      "Please enter the path of a file of owned heroes, e.g. an old owned.csv");
+  std::string after = Menu::GetFreeInput(
+      "Please enter the path of the file to compare it with, or nothing for "
+      "your owned heroes");
+  std::vector<Diff::Difference> differences{};
+  try {
+    differences =
+        Diff::Compare(Diff::Read(catalog, before),
+                      after.empty() ? Diff::Current(catalog)
+                                    : Diff::Read(catalog, after));
+  } catch (std::runtime_error &ex) {
+    std::cout << ex.what() << std::endl;
+    return;
+  }
+  Diff::Print(std::cout, catalog, differences);
+}
+
+void Menu_Cache(Catalog &catalog) {
+  const Cache::Statistics &statistics = catalog.cache.statistics;
+  std::cout << "Filters found in the cache: " << statistics.hits << " out of "
+            << statistics.hits + statistics.misses << " ("
+            << static_cast<int>(statistics.HitRate() * 100) << "%)."
+            << std::endl;
+  std::cout << "Results in the cache: " << statistics.entries << ", using "
+            << statistics.bytes << " out of " << statistics.capacity
+            << " bytes. Results removed to make space: "
+            << statistics.evictions << "." << std::endl;
+
+  if (Menu::YesOrNoInput("Want to change the size of the cache?")) {
+    std::cout << "Enter the new size of the cache in KiB." << std::endl;
+    int kibibytes = Menu::GetIntInput(0, 1024 * 1024);
+    Cache::SetCapacity(catalog.cache, static_cast<size_t>(kibibytes) * 1024);
+  }
+}
@@ -0,0 +1,154 @@
+/**
+ * @file sdsgc.h
+ * @brief The C interface of the sdsgc library, so that other programs can
+ * load heroes and filter them in their own process. It only uses C types, and
+ * stays compatible between versions of the library: functions are only added.
+ *
+ * A catalog and its queries must only be used by one thread at a time, as
+ * evaluating a query updates the catalog's cache. Different catalogs can be
+ * used by different threads.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief A catalog of heroes read from a data directory */
+typedef struct sdsgc_catalog sdsgc_catalog;
+
+/** @brief A compiled filter, for the catalog it was compiled for */
+typedef struct sdsgc_query sdsgc_query;
+
+/** @brief The result of each function that can fail */
+typedef enum sdsgc_status {
+  SDSGC_OK = 0,
+  /** @brief an argument was null or out of range */
+  SDSGC_INVALID_ARGUMENT = 1,
+  /** @brief a data file or profile couldn't be read, or had invalid data */
+  SDSGC_INVALID_DATA = 2,
+  /** @brief a filter couldn't be parsed or compiled */
+  SDSGC_INVALID_QUERY = 3,
+  /** @brief something else went wrong, e.g. out of memory */
+  SDSGC_INTERNAL_ERROR = 4
+} sdsgc_status;
+
+/**
+ * @brief The message about the last error in the calling thread.
+ * @return the message, which is valid until the thread calls another
+ * function, or "" if there was no error
+ */
+const char *sdsgc_last_error(void);
+
+/**
+ * @brief Reads all the data files in a directory into a new catalog. It
+ * doesn't print anything or change the files: messages about them, e.g. that
+ * an update of the owned heroes was only partly saved, are notices (see
+ * sdsgc_catalog_notice).
+ * @param data_dir The directory, e.g. "../data"
+ * @param catalog Set to the catalog, which must be closed with
+ * sdsgc_catalog_close
+ * @return SDSGC_OK, or SDSGC_INVALID_DATA if the data files are invalid
+ */
+sdsgc_status sdsgc_catalog_open(const char *data_dir, sdsgc_catalog **catalog);
+
+/** @brief Frees a catalog. Its queries must be freed first. */
+void sdsgc_catalog_close(sdsgc_catalog *catalog);
+
+/** @return the number of notices from opening a catalog */
+size_t sdsgc_catalog_notice_count(const sdsgc_catalog *catalog);
+
+/**
+ * @param catalog A catalog
+ * @param index The index of a notice, less than sdsgc_catalog_notice_count
+ * @return the notice, which is valid as long as the catalog, or null if index
+ * is out of range
+ */
+const char *sdsgc_catalog_notice(const sdsgc_catalog *catalog, size_t index);
+
+/**
+ * @brief Rewrites owned.csv without the partly saved update that
+ * sdsgc_catalog_open ignored, if there was one, like the program does when it
+ * starts. Otherwise nothing changes.
+ * @param catalog A catalog
+ * @return SDSGC_OK, or SDSGC_INVALID_DATA if the files can't be written
+ */
+sdsgc_status sdsgc_catalog_recover(sdsgc_catalog *catalog);
+
+/** @return the number of heroes in a catalog */
+size_t sdsgc_catalog_size(const sdsgc_catalog *catalog);
+
+/**
+ * @param catalog A catalog
+ * @param row The index of a hero, less than sdsgc_catalog_size
+ * @return the hero's name, e.g. "[Boar Hat] Tavern Master Meliodas", which is
+ * valid as long as the catalog, or null if row is out of range
+ */
+const char *sdsgc_hero_name(const sdsgc_catalog *catalog, size_t row);
+
+/**
+ * @brief Makes a catalog's owned heroes the ones in a profile, a file in the
+ * format of owned.csv. Nothing changes if the profile is invalid.
+ * @param catalog A catalog
+ * @param filename The profile
+ * @return SDSGC_OK, or SDSGC_INVALID_DATA if the profile is invalid
+ */
+sdsgc_status sdsgc_catalog_load_profile(sdsgc_catalog *catalog,
+                                        const char *filename);
+
+/**
+ * @brief Compiles a filter.
+ * @param catalog The catalog the filter is for
+ * @param text The filter in the form the program prints, e.g.
+ * "And(Owned(), Good(1, 2))"
+ * @param query Set to the query, which must be freed with sdsgc_query_free
+ * @return SDSGC_OK, or SDSGC_INVALID_QUERY if the filter is invalid
+ */
+sdsgc_status sdsgc_query_compile(sdsgc_catalog *catalog, const char *text,
+                                 sdsgc_query **query);
+
+/** @brief Frees a query */
+void sdsgc_query_free(sdsgc_query *query);
+
+/**
+ * @brief Finds the heroes a query selects. Results are cached until the
+ * catalog changes, e.g. when a profile is loaded.
+ * @param query A query
+ * @param rows The buffer for the indices of the heroes found, in order. It
+ * can be null if capacity is 0.
+ * @param capacity The size of rows. Only the first capacity heroes are
+ * written.
+ * @param count Set to the number of heroes found, which can be more than
+ * capacity
+ * @return SDSGC_OK
+ */
+sdsgc_status sdsgc_query_evaluate(sdsgc_query *query, size_t *rows,
+                                  size_t capacity, size_t *count);
+
+/**
+ * @brief Starts or stops timing what the library does. Counters always count,
+ * if the library was built with the CMake option STATS.
+ * @param enabled Nonzero to start timing
+ */
+void sdsgc_stats_enable(int enabled);
+
+/** @brief Sets every timer and counter back to 0 */
+void sdsgc_stats_reset(void);
+
+/**
+ * @brief Writes every timer and counter as a JSON document, e.g.
+ * {"compiled": true, "metrics": [{"name": "Cache/hits", "type": "counter",
+ * "count": 3, "total": 3}]}, like snprintf.
+ * @param buffer Where to write it, terminated, unless capacity is 0
+ * @param capacity The size of buffer
+ * @return the length of the whole document, not counting the terminator. If
+ * it's at least capacity, the document was cut short.
+ */
+size_t sdsgc_stats_dump(char *buffer, size_t capacity);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "Generator.h"
+
+namespace Generator {
+namespace {
+/** @brief The kinds of item, so each has its own random numbers */
+enum Stream : uint64_t { HEROES = 1, DRAWS, EVENTS, PROFILES };
+
+const std::array<const char *, 12> CHARACTERS{
+    {"Meliodas", "Diane", "Ban", "King", "Gowther", "Merlin", "Escanor",
+     "Elizabeth", "Zeldris", "Estarossa", "Arthur", "Percival"}};
+const std::array<const char *, 8> TITLES{
+    {"Captain", "Fighter", "Mage", "Knight", "Prince", "Queen", "Demon",
+     "Holy Knight"}};
+const std::array<const char *, 5> ATTRIBUTES{
+    {"Strength", "HP", "Speed", "Light", "Darkness"}};
+const std::array<const char *, 6> RACES{
+    {"Demon", "Giant", "Fairy", "Goddess", "Unknown", "Human"}};
+const std::array<const char *, 7> CHARACTERISTICS{
+    {"The Seven Deadly Sins", "Four Knights of the Apocalypse",
+     "The Four Archangels", "The Ten Commandments", "Ragnarok",
+     "The Seven Catastrophes", "Collab"}};
+const std::array<const char *, 5> GRADES{{"R", "SR", "SSR", "UR", "LR"}};
+
+/** @brief The number of tier lists in heroes.csv */
+constexpr size_t TIER_LISTS{4};
+
+/** @brief The size of the buffer of each file */
+constexpr size_t BUFFER_SIZE{1 << 20};
+
+/** @brief The fields of heroes.csv that profiles need */
+struct HeroData {
+  size_t starting_grade;
+  bool lr;
+  /** @brief The best tier on any list, or 0 if it isn't on any */
+  uint64_t best_tier;
+};
+
+/**
+ * @brief Makes the record of a hero in heroes.csv. Records only depend on the
+ * seed and index, so profiles can make them again.
+ * @param *record Set to the fields, unless it's nullptr
+ * @return the fields profiles need
+ */
+HeroData MakeHero(const Options &options, uint64_t index,
+                  std::array<std::string, 8 + TIER_LISTS> *record) {
+  Random random{options.seed, HEROES, index};
+
+  // mostly SSRs, like the real heroes
+  uint64_t roll = random.Below(20);
+  HeroData data{roll < 2 ? 0U : roll < 8 ? 1U : roll < 19 ? 2U : 3U,
+                random.Chance(0.1), 0};
+
+  // the same random numbers are used whether or not the record is made
+  uint64_t race = random.Below(RACES.size());
+  std::string races = RACES[race];
+  for (uint64_t i{1}; i < options.max_races && i < RACES.size(); i++) {
+    if (!random.Chance(options.extra_race)) {
+      break;
+    }
+    // a different race from the one before
+    race = (race + 1 + random.Below(RACES.size() - 1)) % RACES.size();
+    races += std::string{","} + RACES[race];
+  }
+  const char *attribute = ATTRIBUTES[random.Below(ATTRIBUTES.size())];
+  const char *characteristic =
+      CHARACTERISTICS[random.Below(CHARACTERISTICS.size())];
+  if (record != nullptr) {
+    std::string character = CHARACTERS[index % CHARACTERS.size()];
+    (*record)[0] = HeroName(index);
+    (*record)[1] = TITLES[(index / CHARACTERS.size()) % TITLES.size()] +
+                   std::string{" "} + character;
+    (*record)[2] = attribute;
+    (*record)[3] = GRADES[data.starting_grade];
+    (*record)[4] = character;
+    (*record)[5] = data.lr ? "true" : "false";
+    (*record)[6] = races;
+    (*record)[7] = characteristic;
+  }
+
+  double total{0};
+  for (double weight : options.tier_weights) {
+    total += weight;
+  }
+  for (size_t i{0}; i < TIER_LISTS; i++) {
+    double roll_tier = random.Fraction() * total;
+    uint64_t tier{0};
+    while (tier + 1 < options.tier_weights.size() &&
+           roll_tier >= options.tier_weights[tier]) {
+      roll_tier -= options.tier_weights[tier];
+      tier++;
+    }
+    if (record != nullptr) {
+      (*record)[8 + i] = std::to_string(tier);
+    }
+    if (tier > 0 && (data.best_tier == 0 || tier < data.best_tier)) {
+      data.best_tier = tier;
+    }
+  }
+  return data;
+}
+
+/** @brief Opens a file to write with a large buffer, or throws */
+std::unique_ptr<std::ofstream> Open(const std::string &filename,
+                                    std::unique_ptr<char[]> &buffer) {
+  buffer.reset(new char[BUFFER_SIZE]);
+  std::unique_ptr<std::ofstream> file{new std::ofstream{}};
+  file->rdbuf()->pubsetbuf(buffer.get(), BUFFER_SIZE);
+  file->open(filename, std::ios::binary);
+  if (!file->good()) {
+    throw std::runtime_error("Could not open " + filename + " to write.");
+  }
+  return file;
+}
+
+/** @brief Flushes and closes a file, or throws */
+void Close(std::ofstream &file, const std::string &filename) {
+  file.close();
+  if (file.fail()) {
+    throw std::runtime_error("Could not write to " + filename + ".");
+  }
+}
+} // namespace
+
+Random::Random(uint64_t seed, uint64_t stream, uint64_t index)
+    : state{seed ^ (stream * 0xD1B54A32D192ED03ULL)} {
+  state ^= Random{index + 0x632BE59BD9B4E019ULL}.Next();
+  Next();
+}
+
+uint64_t Random::Next() {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t Random::Below(uint64_t n) {
+  // the bias of the remainder is negligible for the small n used here
+  return Next() % n;
+}
+
+double Random::Fraction() {
+  return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+Options::Options()
+    : seed{1}, heroes{309}, max_races{2}, extra_race{0.1},
+      tier_weights{{30, 10, 15, 20, 15, 10}}, draws{10}, events{3},
+      min_list{10}, max_list{40}, profiles{1}, owned{0.3} {}
+
+void WriteField(std::ostream &os, const std::string &field, bool first) {
+  if (!first) {
+    os.put(',');
+  }
+  if (field.find_first_of(",\"") == std::string::npos) {
+    os << field;
+    return;
+  }
+  os.put('"');
+  for (char ch : field) {
+    if (ch == '"') {
+      os.put('"');
+    }
+    os.put(ch);
+  }
+  os.put('"');
+}
+
+std::string HeroName(uint64_t index) {
+  std::string number = std::to_string(index);
+  std::string rest = std::string{" "} +
+                     TITLES[(index / CHARACTERS.size()) % TITLES.size()] +
+                     " " + CHARACTERS[index % CHARACTERS.size()];
+  // the real names have quotes, e.g. "Venom Mixing" Herbalist Nasiens; commas
+  // are made up, but allowed
+  if (index % 128 == 33) {
+    return "\"Legend, " + number + "\"" + rest;
+  }
+  if (index % 64 == 17) {
+    return "[Legend, " + number + "]" + rest;
+  }
+  if (index % 16 == 5) {
+    return "\"Legend " + number + "\"" + rest;
+  }
+  return "[Legend " + number + "]" + rest;
+}
+
+void WriteHeroes(std::ostream &os, const Options &options) {
+  std::array<std::string, 8 + TIER_LISTS> record{};
+  for (uint64_t i{0}; i < options.heroes; i++) {
+    MakeHero(options, i, &record);
+    for (size_t j{0}; j < record.size(); j++) {
+      WriteField(os, record[j], j == 0);
+    }
+    os.put('\n');
+  }
+}
+
+void WriteLists(std::ostream &os, const Options &options,
+                const std::string &prefix, uint64_t count, uint64_t stream) {
+  for (uint64_t i{0}; i < count; i++) {
+    Random random{options.seed, stream, i};
+    if (i > 0) {
+      os.put('\n');
+    }
+    os << prefix << " " << i << "\n";
+    uint64_t length = options.min_list +
+                      random.Below(options.max_list - options.min_list + 1);
+    for (uint64_t j{0}; j < length; j++) {
+      WriteField(os, HeroName(random.Below(options.heroes)), j == 0);
+    }
+    os.put('\n');
+  }
+}
+
+void WriteProfile(std::ostream &os, const Options &options, uint64_t profile) {
+  Random random{options.seed, PROFILES, profile};
+  // some players own a few heroes, some most of them
+  double activity = options.owned * (0.25 + 1.5 * random.Fraction());
+
+  for (uint64_t i{0}; i < options.heroes; i++) {
+    HeroData hero = MakeHero(options, i, nullptr);
+    // 1 for the best heroes, 0 for heroes on no tier list
+    double goodness =
+        hero.best_tier == 0 ? 0.0
+                            : static_cast<double>(6 - hero.best_tier) / 5.0;
+    if (!random.Chance(std::min(1.0, activity * (0.5 + goodness)))) {
+      continue;
+    }
+
+    // most heroes are barely upgraded; good ones more often are
+    double skew = 2.5 - 1.5 * goodness;
+    size_t grade = hero.starting_grade +
+                   static_cast<size_t>(
+                       std::pow(random.Fraction(), skew) *
+                       static_cast<double>(4 - hero.starting_grade));
+    if (grade == 4 && !hero.lr) {
+      grade = 3;
+    }
+    uint64_t level =
+        30 + 5 * static_cast<uint64_t>(std::pow(random.Fraction(), skew) * 15);
+    uint64_t stars =
+        static_cast<uint64_t>(std::pow(random.Fraction(), 3.0) * 13);
+    bool unique = random.Chance(0.3 + 0.5 * goodness);
+    uint64_t ultimate =
+        1 + static_cast<uint64_t>(std::pow(random.Fraction(), 2.0) * 6);
+
+    WriteField(os, HeroName(i), true);
+    WriteField(os, GRADES[grade], false);
+    WriteField(os, std::to_string(level), false);
+    WriteField(os, std::to_string(stars), false);
+    WriteField(os, unique ? "true" : "false", false);
+    WriteField(os, std::to_string(ultimate), false);
+    os.put('\n');
+  }
+}
+
+void Generate(const std::string &data_dir, const Options &options) {
+  if (options.heroes == 0 || options.min_list > options.max_list) {
+    throw std::runtime_error("There must be at least 1 hero, and the shortest "
+                             "list can't be longer than the longest.");
+  }
+  std::unique_ptr<char[]> buffer{};
+
+  std::string filename = data_dir + "/heroes.csv";
+  std::unique_ptr<std::ofstream> file = Open(filename, buffer);
+  WriteHeroes(*file, options);
+  Close(*file, filename);
+
+  filename = data_dir + "/draws.txt";
+  file = Open(filename, buffer);
+  WriteLists(*file, options, "Draw", options.draws, DRAWS);
+  Close(*file, filename);
+
+  filename = data_dir + "/acquisition.txt";
+  file = Open(filename, buffer);
+  WriteLists(*file, options, "Event", options.events, EVENTS);
+  Close(*file, filename);
+
+  if (options.profiles > 1) {
+#ifdef _WIN32
+    mkdir((data_dir + "/profiles").c_str());
+#else
+    mkdir((data_dir + "/profiles").c_str(), 0755);
+#endif
+  }
+  for (uint64_t i{0}; i < options.profiles; i++) {
+    filename = i == 0 ? data_dir + "/owned.csv"
+                      : data_dir + "/profiles/" + std::to_string(i) + ".csv";
+    file = Open(filename, buffer);
+    WriteProfile(*file, options, i);
+    Close(*file, filename);
+  }
+}
+} // namespace Generator
@@ -0,0 +1,129 @@
+/**
+ * @file Generator.h
+ * @brief Generator namespace writes synthetic data files of any size, in the
+ * formats the program reads, for load testing and benchmarks.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Generator namespace writes synthetic data files of any size, in the
+ * formats the program reads. Every file is written a record at a time, so
+ * files much bigger than memory can be made, and the same options always make
+ * the same files, on any platform.
+ */
+namespace Generator {
+
+/**
+ * @brief A small random number generator (SplitMix64). It's used instead of
+ * the standard engines and distributions, whose results differ between
+ * standard libraries.
+ */
+class Random {
+public:
+  explicit Random(uint64_t state) : state{state} {}
+
+  /**
+   * @brief A generator for one item of one kind, e.g. the hero with index 12,
+   * so that any item can be made again without making the ones before it.
+   * @param seed The seed of all the data
+   * @param stream The kind of item
+   * @param index The index of the item
+   */
+  Random(uint64_t seed, uint64_t stream, uint64_t index);
+
+  /** @return the next 64 random bits */
+  uint64_t Next();
+
+  /** @return a number between 0 and n - 1. n must be positive. */
+  uint64_t Below(uint64_t n);
+
+  /** @return a number between 0 and 1, not including 1 */
+  double Fraction();
+
+  /** @return true with probability p */
+  bool Chance(double p) { return Fraction() < p; }
+
+private:
+  uint64_t state;
+};
+
+/** @brief What to generate */
+struct Options {
+  Options();
+
+  uint64_t seed;
+  /** @brief The number of heroes in heroes.csv */
+  uint64_t heroes;
+  /** @brief The most races a hero can have */
+  uint64_t max_races;
+  /** @brief The probability of each race after the first */
+  double extra_race;
+  /** @brief The relative weights of tiers 0 to 5 in each tier list */
+  std::array<double, 6> tier_weights;
+  /** @brief The number of headings in draws.txt */
+  uint64_t draws;
+  /** @brief The number of headings in acquisition.txt */
+  uint64_t events;
+  /** @brief The shortest and longest list of heroes under each heading */
+  uint64_t min_list;
+  uint64_t max_list;
+  /** @brief The number of profiles, i.e. owned.csv files, to write. The first
+   * is owned.csv; the rest are profiles/NUMBER.csv. */
+  uint64_t profiles;
+  /** @brief The average fraction of the heroes each profile owns */
+  double owned;
+};
+
+/**
+ * @brief Writes a field of a CSV record, quoted as in RFC 4180 if it has a
+ * comma or quote, e.g. "Venom Mixing" Herbalist Nasiens is written as
+ * """Venom Mixing"" Herbalist Nasiens".
+ * @param &os Where to write it
+ * @param &field The field
+ * @param first Whether it's the first field of the record, i.e. has no comma
+ * before it
+ */
+void WriteField(std::ostream &os, const std::string &field, bool first);
+
+/**
+ * @param index The index of a hero
+ * @return the hero's name in heroes.csv. Some need quoting, since they have
+ * quotes or commas in them.
+ */
+std::string HeroName(uint64_t index);
+
+/** @brief Writes heroes.csv */
+void WriteHeroes(std::ostream &os, const Options &options);
+
+/**
+ * @brief Writes a list of headings and heroes, like draws.txt.
+ * @param &prefix The start of each heading, e.g. Draw
+ * @param count The number of headings
+ * @param stream Which random numbers to use, so each file is different
+ */
+void WriteLists(std::ostream &os, const Options &options,
+                const std::string &prefix, uint64_t count, uint64_t stream);
+
+/**
+ * @brief Writes a profile, i.e. an owned.csv. How many heroes it owns, and how
+ * upgraded they are, varies between profiles; good heroes are more often
+ * owned and upgraded.
+ * @param profile The number of the profile
+ */
+void WriteProfile(std::ostream &os, const Options &options, uint64_t profile);
+
+/**
+ * @brief Writes heroes.csv, draws.txt, acquisition.txt, owned.csv and any
+ * more profiles.
+ * @param &data_dir The directory to write them in, which must exist
+ * @param &options What to generate
+ * @throw std::runtime_error if a file can't be written
+ */
+void Generate(const std::string &data_dir, const Options &options);
+} // namespace Generator
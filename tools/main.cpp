@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Generator.h"
+#include "Utilities.h"
+
+namespace {
+void Usage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " DIRECTORY [options]\n"
+      << "Writes heroes.csv, draws.txt, acquisition.txt and owned.csv in\n"
+         "DIRECTORY, which must exist.\n"
+         "  --seed N             the same seed makes the same files (1)\n"
+         "  --heroes N           the number of heroes (309)\n"
+         "  --max-races N        the most races a hero has (2)\n"
+         "  --extra-race P       the probability of each extra race (0.1)\n"
+         "  --tiers W0,...,W5    the weights of tiers 0 to 5\n"
+         "                       (30,10,15,20,15,10)\n"
+         "  --draws N            the number of headings in draws.txt (10)\n"
+         "  --events N           the number of headings in acquisition.txt "
+         "(3)\n"
+         "  --list MIN,MAX       the length of each list of heroes (10,40)\n"
+         "  --profiles N         owned.csv, and N - 1 more profiles in\n"
+         "                       DIRECTORY/profiles (1)\n"
+         "  --owned F            the average fraction of heroes each profile\n"
+         "                       owns (0.3)"
+      << std::endl;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argv[1][0] == '-') {
+    Usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  std::string directory{argv[1]};
+  Generator::Options options{};
+
+  try {
+    for (int i{2}; i < argc; i += 2) {
+      std::string arg{argv[i]};
+      if (i + 1 >= argc) {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      std::string value{argv[i + 1]};
+      if (arg == "--seed") {
+        options.seed = std::stoull(value);
+      } else if (arg == "--heroes") {
+        options.heroes = std::stoull(value);
+      } else if (arg == "--max-races") {
+        options.max_races = std::stoull(value);
+      } else if (arg == "--extra-race") {
+        options.extra_race = std::stod(value);
+      } else if (arg == "--tiers") {
+        std::vector<std::string> weights = Utilities::ParseCSV(value);
+        if (weights.size() != options.tier_weights.size()) {
+          throw std::invalid_argument("--tiers needs 6 weights");
+        }
+        for (size_t j{0}; j < weights.size(); j++) {
+          options.tier_weights[j] = std::stod(weights[j]);
+        }
+      } else if (arg == "--draws") {
+        options.draws = std::stoull(value);
+      } else if (arg == "--events") {
+        options.events = std::stoull(value);
+      } else if (arg == "--list") {
+        std::vector<std::string> lengths = Utilities::ParseCSV(value);
+        if (lengths.size() != 2) {
+          throw std::invalid_argument("--list needs MIN,MAX");
+        }
+        options.min_list = std::stoull(lengths[0]);
+        options.max_list = std::stoull(lengths[1]);
+      } else if (arg == "--profiles") {
+        options.profiles = std::stoull(value);
+      } else if (arg == "--owned") {
+        options.owned = std::stod(value);
+      } else {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+
+    Generator::Generate(directory, options);
+  } catch (std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
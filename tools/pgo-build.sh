@@ -0,0 +1,76 @@
+#!/bin/sh
+# Builds sdsgc-information-tool with profile guided and link time
+# optimisation, on Linux with GCC or Clang:
+#   1. builds a program that records how often each part of it runs,
+#   2. runs the training workload on generated data: loading the data, the
+#      filters in tools/training/filters.txt through --batch, and the
+#      benchmarks, which also update owned heroes,
+#   3. builds again, optimised for what ran most.
+# Then it times the workload with the optimised program and with a release
+# build without the profile, to show the difference.
+#
+# Usage: tools/pgo-build.sh [BUILD_DIRECTORY]
+# SCALE sets the size of the training data, in times the real data (default
+# 20), and COMPARE=0 skips the comparison.
+set -eu
+
+SOURCE=$(cd "$(dirname "$0")/.." && pwd)
+BUILD=${1:-build-pgo}
+SCALE=${SCALE:-20}
+COMPARE=${COMPARE:-1}
+JOBS=$(nproc 2>/dev/null || echo 2)
+mkdir -p "$BUILD"
+BUILD=$(cd "$BUILD" && pwd)
+PROFILE="$BUILD/pgo-profile"
+DATA="$BUILD/training-data"
+FILTERS="$SOURCE/tools/training/filters.txt"
+
+# the real data has about 10 draws and 3 events
+generate() {
+    mkdir -p "$2"
+    "$1/sdsgc-generate" "$2" --seed 1 --heroes $((309 * SCALE)) \
+        --draws $((10 * SCALE)) --events $((3 * SCALE))
+}
+
+# runs the filters 5 times, each time loading the data again
+workload() {
+    for _ in 1 2 3 4 5; do
+        "$1/sdsgc-information-tool" --batch --data "$DATA" <"$FILTERS" \
+            >/dev/null 2>&1
+    done
+}
+
+echo "== 1. Building the instrumented program"
+rm -rf "$PROFILE"
+cmake -S "$SOURCE" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DLTO=ON \
+    -DPGO=GENERATE -DPGO_DIR="$PROFILE"
+cmake --build "$BUILD" -j"$JOBS"
+
+echo "== 2. Running the training workload"
+generate "$BUILD" "$DATA"
+workload "$BUILD"
+"$BUILD/sdsgc-bench" --scales "1,$SCALE" --warmup 0 --repetitions 2 \
+    --dir "$BUILD/training-bench" --json "$BUILD/training-bench.json" \
+    >/dev/null
+if grep -q Clang "$BUILD/CMakeCache.txt"; then
+    llvm-profdata merge -output="$PROFILE/default.profdata" "$PROFILE"/*.profraw
+fi
+
+echo "== 3. Building the optimised program"
+# the same directory, so the profile of each file is found again
+cmake -S "$SOURCE" -B "$BUILD" -DPGO=USE
+cmake --build "$BUILD" -j"$JOBS" --clean-first
+
+if [ "$COMPARE" = 1 ]; then
+    echo "== Comparing with a release build without the profile"
+    cmake -S "$SOURCE" -B "$BUILD/release" -DCMAKE_BUILD_TYPE=Release \
+        -DLTO=ON >/dev/null
+    cmake --build "$BUILD/release" -j"$JOBS" >/dev/null
+    for program in "$BUILD/release" "$BUILD"; do
+        start=$(date +%s%N)
+        workload "$program"
+        end=$(date +%s%N)
+        echo "$program: $(((end - start) / 1000000)) ms"
+    done
+fi
+echo "The optimised program is $BUILD/sdsgc-information-tool"